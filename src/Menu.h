@@ -4,15 +4,26 @@
 class Menu {
 public:
     Menu(SDL_Renderer* renderer);
+    ~Menu();
+    Menu(const Menu&) = delete;
+    Menu& operator=(const Menu&) = delete;
     
     void handleEvent(const SDL_Event& event);
     void update(float deltaTime);  // Add this
+    void setLoadProgress(float progress);  // 0..1, drawn as a bar under the button
     void render();
     bool shouldStartGame() const;
     void reset();
 
 private:
+    static const int MENU_WIDTH = 640;
+    static const int MENU_HEIGHT = 320;
+
+    void bakeBackground();
+
     SDL_Renderer* renderer_;
     bool startGame;
     float pulseTime;
+    float loadProgress;
+    SDL_Texture* background;  // static parts, baked on the first render
 };
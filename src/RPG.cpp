@@ -5,9 +5,40 @@
 #include <string>
 #include <array>
 #include <format>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
 
 #include "animation.h"
 #include "gameobject.h"
+#include "tilemap.h"
+#include "bulletpool.h"
+#include "fixedstep.h"
+#include "bench.h"
+#include "chunkcache.h"
+#include "culling.h"
+#include "atlas.h"
+#include "spritebatch.h"
+#include "assets.h"
+#include "bundle.h"
+#include "maps.h"
+#include "levelfile.h"
+#include "levelstream.h"
+#include "profiler.h"
+#include "jobs.h"
+#include "enemies.h"
+#include "broadphase.h"
+#include "sweep.h"
+#include "parallax.h"
+#include "assetloader.h"
+#include "Menu.h"
+#include "pacing.h"
+#include "replay.h"
+#include "snapshot.h"
+#include "alloctrack.h"
+#include "framearena.h"
+#include "renderqueue.h"
+#include "pipeline.h"
 
 using namespace std;
 
@@ -16,8 +47,9 @@ struct SDLState {
 	SDL_Renderer* renderer;
 	int width, height, logW, logH;
 	const bool* keys;
+	bool headless;
 
-	SDLState() : keys(SDL_GetKeyboardState(nullptr))
+	SDLState() : keys(SDL_GetKeyboardState(nullptr)), headless(false)
 	{
 
 	}
@@ -25,259 +57,1357 @@ struct SDLState {
 
 const size_t LAYER_IDX_LEVEL = 0;
 const size_t LAYER_IDX_CHARACTERS = 1;
-const int MAP_ROWS = 5;
-const int MAP_COLS = 50;
 const int TILE_SIZE = 32;
+const int LEVEL_STREAM_RADIUS = 2;
+const char* const DEFAULT_LEVEL_PATH = "data/level1.lvl";
+const float CULL_MARGIN = TILE_SIZE;
+const int ATLAS_WIDTH = 2048;
+const size_t MAX_BULLETS = 256;
+const int DEFAULT_TICK_RATE = 120;
+const int DEFAULT_MAX_CATCHUP_STEPS = 8;
+const int BENCH_WARMUP_FRAMES = 30;
+const uint64_t BENCH_FRAME_NS = 1000000000ull / 60;
+const uint32_t PROFILE_CAPTURE_FRAMES = 120;
+const size_t ENTITY_BATCH = 1024;
+const size_t BULLET_BATCH = 64;
+const size_t ANIM_BATCH = 16384;
+const size_t ENEMY_BATCH = 2048;
+const float ENEMY_KNOCKBACK_Y = -150.0f;
+const char* const PROFILE_CAPTURE_PATH = "profile.json";
+const int DEFAULT_FPS_CAP = 60;
+const size_t SNAPSHOT_HISTORY_TICKS = 600; // how far Backspace rewinds, 5 s at the default rate
+const size_t SNAPSHOT_HISTORY_BYTES = 32u << 20; // delta storage, big states fit fewer ticks
+const size_t FRAME_ARENA_BYTES = 4u << 20; // per buffer, scratch of one frame
+
+// command line settings
+struct Options
+{
+	int tickRate;
+	int maxCatchupSteps;
+	int benchFrames; // > 0 runs headless and prints timings instead of playing
+	std::string levelPath;
+	int animStress;   // extra animation instances stepped every frame
+	std::string tracePath; // Chrome trace of the last frames, written on exit
+	int jobs;         // worker threads, -1 picks one per spare core, 0 runs everything serially
+	int stress;       // extra enemies spread over the start of the level
+	bool looseAssets; // decode the pngs instead of mapping the cooked bundle
+	PacingMode pacing;
+	bool pacingSet;   // headless runs default to uncapped unless a mode was asked for
+	int fpsCap;
+	std::string recordPath; // input and per-tick checksums of the session, written on exit
+	std::string replayPath; // plays a recording back instead of reading the keyboard
+	int rollback;           // ticks restored and resimulated every frame, to test and time rollbacks
+	bool pipeline;          // simulate a frame on its own thread while the previous one is submitted
+
+	Options()
+	{
+		tickRate = DEFAULT_TICK_RATE;
+		maxCatchupSteps = DEFAULT_MAX_CATCHUP_STEPS;
+		benchFrames = 0;
+		levelPath = DEFAULT_LEVEL_PATH;
+		animStress = 0;
+		jobs = -1;
+		stress = 0;
+		looseAssets = false;
+		pacing = PacingMode::vsync;
+		pacingSet = false;
+		fpsCap = DEFAULT_FPS_CAP;
+		rollback = 0;
+		pipeline = true;
+	}
+};
+
+
+// shared-state writes an update wants to make, applied after the parallel phase
+struct BulletSpawn
+{
+	glm::vec2 position;
+	float direction;
+};
+
+struct TickOutput
+{
+	FrameVector<BulletSpawn> bulletSpawns;
+	FrameVector<float> playerHits; // direction each hit pushes the player
+
+	explicit TickOutput(FrameArena& arena)
+		: bulletSpawns(FrameAllocator<BulletSpawn>(arena)), playerHits(FrameAllocator<float>(arena)) {}
+
+	void clear()
+	{
+		bulletSpawns.clear();
+		playerHits.clear();
+	}
+};
+
+// keyboard input of one tick, kept so a rollback can resimulate it: the keys held as
+// packReplayKeys bits and the ones pressed since the tick before
+struct TickInput
+{
+	uint8_t keys;
+	uint8_t presses;
+};
 
+// broadphase group of a body, pairs come out ordered by it: player < enemy < bullet
+inline uint8_t bodyGroup(ObjectType type) { return static_cast<uint8_t>(type); }
 
 struct GameState
 {
-	std::array<std::vector<GameObject>, 2> layers;
-	std::vector<GameObject> backgroundTiles;
-	std::vector<GameObject> foregroundTiles;
-	std::vector<GameObject> bullets;
+	std::array<std::vector<GameObject>, 2> layers; // dynamic objects, static tiles live in tiles
+	BulletPool bullets;
+	Animator animator;
+	JobSystem jobs;
+	FrameArena arena; // scratch of the current and the previous frame
+	EnemySystem enemies;
+	std::vector<uint8_t> spawnedChunks; // level chunks whose enemy markers were already used
+	uint64_t enemyUpdateTicks;       // performance counter ticks spent on enemies this frame
+	int playerHits;
+	SweepAndPrune broadphase;       // player, enemy and bullet boxes, grouped by ObjectType
+	size_t contactCount, pairTests; // this frame, over every tick
+	size_t maxContacts;             // most pairs a single tick has produced
+	TileMap tiles; // LEVEL_LAYER_* layers of the resident window
+	ChunkCache levelChunks, foregroundChunks, backgroundChunks;
+	LevelStream level;
+	ViewCuller culler;
+	SpriteBatch batch;
+	ParallaxCompositor parallax;
 	int playerIndex;
 	SDL_FRect mapViewport;
-	float bg2Scroll, bg3Scroll, bg4Scroll, bg5Scroll, bg6Scroll;
+	uint32_t tick; // fixed ticks simulated so far
+	uint32_t windowBuilds; // buildLevelWindow calls, frames that rebuild the window may allocate
+	std::vector<int32_t> restoredWindow; // loadState scratch
 
-	GameState(const SDLState  &state)
+	GameState(const SDLState  &state) : arena(FRAME_ARENA_BYTES)
 	{
 		playerIndex = -1;
+		tick = 0;
+		windowBuilds = 0;
+		enemyUpdateTicks = 0;
+		playerHits = 0;
+		contactCount = pairTests = 0;
+		maxContacts = 0;
+		broadphase.enable(bodyGroup(ObjectType::player), bodyGroup(ObjectType::enemy));
+		broadphase.enable(bodyGroup(ObjectType::enemy), bodyGroup(ObjectType::bullet));
 		mapViewport = SDL_FRect{
 		.x = 0, .y = 0,
 		.w = static_cast<float>(state.logW),
 		.h = static_cast<float>(state.logH)
 		};
-		bg2Scroll = bg3Scroll = bg4Scroll = bg5Scroll = bg6Scroll = 0;
 	}
 	GameObject& player() { return layers[LAYER_IDX_CHARACTERS][playerIndex]; }
 };
 
 struct Resources {
+	// ids into clips, shared by every animated object
 	const int ANIM_PLAYER_IDLE = 0;
 	const int ANIM_PLAYER_RUNNING = 1;
 	const int ANIM_PLAYER_SLIDE = 2;
-	std::vector<Animation> playerAnims;
-	const int ANIM_BULLET_MOVING = 0;
-	const int ANIM_BULLET_HIT = 1;
-	std::vector<Animation> bulletAnims;
+	const int ANIM_BULLET_MOVING = 3;
+	const int ANIM_BULLET_HIT = 4;
+	std::vector<AnimationClip> clips;
+
+	SDL_Texture* atlasTexture;
+	Sprite sprIdle, sprRun, sprSlide, sprGrass, sprDeepGrass, sprGrassR, sprGrassL, sprGrassConL, sprGrassConR,
+		sprBg1, sprBg2, sprBg3, sprBg4, sprBg5, sprBg6, sprBullet, sprBulletHit;
+	double loadMs;
+
+	AssetLoader loader;
+	std::vector<SDL_Surface*> decoded; // ASSET_LIST order, filled in as the loader finishes files
+	LoadStatus status;
+	bool loose;
+	uint64_t loadStart;
 
-	std::vector<SDL_Texture*> textures;
-	SDL_Texture *texIdle, *texRun, *texSlide, *texGrass, *texDeepGrass, *texGrassR, *texGrassL, *texGrassConL, *texGrassConR,
-		*texBg1, *texBg2, *texBg3, *texBg4, *texBg5, *texBg6, *texBullet, *texBulletHit;
+	Resources() : atlasTexture(nullptr), loadMs(0), status(LoadStatus::done), loose(false), loadStart(0) {}
 
-	SDL_Texture* loadTexture(SDL_Renderer* renderer, const std::string& filepath)
+	// sprite members in ASSET_LIST order
+	std::array<Sprite*, ASSET_COUNT> sprites()
 	{
-		SDL_Texture* tex = IMG_LoadTexture(renderer, filepath.c_str());
-		SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
-		return tex;
-	};
+		return { &sprIdle, &sprRun, &sprSlide, &sprGrass, &sprDeepGrass, &sprGrassR, &sprGrassL, &sprGrassConR, &sprGrassConL,
+			&sprBg1, &sprBg2, &sprBg3, &sprBg4, &sprBg5, &sprBg6, &sprBullet };
+	}
 
-	void load(SDLState& state)
-	{
-		// animation initialization
-		playerAnims.resize(5);
-		playerAnims[ANIM_PLAYER_IDLE] = Animation(4, 0.8f);
-		playerAnims[ANIM_PLAYER_RUNNING] = Animation(4, 0.5f);
-		playerAnims[ANIM_PLAYER_SLIDE] = Animation(1, 1.0f);
-		bulletAnims.resize(2);
-		bulletAnims[ANIM_BULLET_MOVING] = Animation(4, 0.08f);
-		bulletAnims[ANIM_BULLET_HIT] = Animation(4, 0.15f);
-
-
-		// texture initialization
-		texIdle = loadTexture(state.renderer, "data/idle.png");
-		texRun = loadTexture(state.renderer, "data/run.png");
-		texSlide = loadTexture(state.renderer, "data/slide.png");
-		texGrass = loadTexture(state.renderer, "data/Tiles/grass1.png");
-		texDeepGrass = loadTexture(state.renderer, "data/Tiles/deepGrass.png");
-		texGrassR = loadTexture(state.renderer, "data/Tiles/grassR.png");
-		texGrassL = loadTexture(state.renderer, "data/Tiles/grassL.png");
-		texGrassConR = loadTexture(state.renderer, "data/Tiles/grassConR.png");
-		texGrassConL = loadTexture(state.renderer, "data/Tiles/grassConL.png");
-		texBg1 = loadTexture(state.renderer, "data/Background/j1.png");
-		texBg2 = loadTexture(state.renderer, "data/Background/j2.png");
-		texBg3 = loadTexture(state.renderer, "data/Background/j3.png");
-		texBg4 = loadTexture(state.renderer, "data/Background/j4.png");
-		texBg5 = loadTexture(state.renderer, "data/Background/j5.png");
-		texBg6 = loadTexture(state.renderer, "data/Background/j6.png");
-		texBullet = loadTexture(state.renderer, "data/bullet.png");
-		texBulletHit = loadTexture(state.renderer, "data/j6.png");
+	// cooked bundle: map the pre-packed pixels straight into the atlas texture, no decoding
+	bool loadBundle(SDLState& state)
+	{
+		AssetBundle bundle;
+		if (!bundle.open(ASSET_BUNDLE_PATH))
+		{
+			SDL_Log("Missing or outdated asset bundle %s, run the cooker", ASSET_BUNDLE_PATH);
+			return false;
+		}
+		atlasTexture = SDL_CreateTexture(state.renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, bundle.width(), bundle.height());
+		if (!atlasTexture || !SDL_UpdateTexture(atlasTexture, nullptr, bundle.pixels(), bundle.pitch()))
+		{
+			SDL_Log("Failed to upload atlas: %s", SDL_GetError());
+			return false;
+		}
+		SDL_SetTextureBlendMode(atlasTexture, SDL_BLENDMODE_BLEND);
+		SDL_SetTextureScaleMode(atlasTexture, SDL_SCALEMODE_NEAREST);
 
+		const auto slots = sprites();
+		for (size_t i = 0; i < ASSET_COUNT; i++)
+		{
+			const BundleEntry* entry = bundle.find(ASSET_LIST[i].name);
+			if (!entry)
+			{
+				SDL_Log("Asset bundle has no entry \"%s\"", ASSET_LIST[i].name);
+				return false;
+			}
+			slots[i]->texture = atlasTexture;
+			slots[i]->rect = SDL_FRect{ entry->x, entry->y, entry->w, entry->h };
+			slots[i]->frameCount = entry->frameCount;
+		}
+		return true;
+	}
+
+	// loose files: every png has been decoded by the loader, pack them and upload the
+	// whole atlas in one go
+	bool loadLoose(SDLState& state)
+	{
+		loader.stop();
+		bool complete = true;
+		for (SDL_Surface* image : decoded)
+		{
+			complete = complete && image;
+		}
+		if (!complete)
+		{
+			for (SDL_Surface* image : decoded)
+			{
+				SDL_DestroySurface(image);
+			}
+			decoded.clear();
+			return false;
+		}
+
+		TextureAtlas atlas(ATLAS_WIDTH);
+		const auto slots = sprites();
+		for (size_t i = 0; i < ASSET_COUNT; i++)
+		{
+			atlas.add(decoded[i], *slots[i]);
+			slots[i]->frameCount = ASSET_LIST[i].frameCount;
+		}
+		decoded.clear();
+		atlasTexture = atlas.build(state.renderer);
+		return atlasTexture != nullptr;
+	}
+
+	// loose assets start decoding on worker threads right away, the bundle needs no
+	// decoding and is mapped by the first pollLoad
+	void beginLoad(bool looseAssets, size_t workers)
+	{
+		atlasTexture = nullptr;
+		loose = looseAssets;
+		status = LoadStatus::loading;
+		loadStart = SDL_GetTicksNS();
+		if (loose)
+		{
+			std::vector<std::string> paths;
+			for (const AssetInfo& asset : ASSET_LIST)
+			{
+				paths.push_back(std::string(DATA_DIR) + asset.path);
+			}
+			decoded.assign(ASSET_COUNT, nullptr);
+			loader.start(std::move(paths), workers);
+		}
+	}
+
+	// call on the render thread between frames until it stops returning loading;
+	// textures are only created here
+	LoadStatus pollLoad(SDLState& state)
+	{
+		if (status != LoadStatus::loading || (loose && !loader.collect(decoded)))
+		{
+			return status;
+		}
+		if (!(loose ? loadLoose(state) : loadBundle(state)))
+		{
+			status = LoadStatus::failed;
+			return status;
+		}
+		// there is no hit sheet yet, the hit animation reuses the bullet
+		sprBulletHit = sprBullet;
+		loadMs = (SDL_GetTicksNS() - loadStart) / 1e6;
+
+		// animation clips in ANIM_* order, frame counts come from the asset manifest
+		clips.clear();
+		clips.emplace_back(sprIdle.frameCount, 0.8f);
+		clips.emplace_back(sprRun.frameCount, 0.5f);
+		clips.emplace_back(sprSlide.frameCount, 1.0f);
+		clips.emplace_back(sprBullet.frameCount, 0.08f);
+		clips.emplace_back(sprBulletHit.frameCount, 0.15f);
+		status = LoadStatus::done;
+		return status;
+	}
+
+	// fraction of the files decoded so far
+	float loadProgress() const
+	{
+		if (status != LoadStatus::loading)
+		{
+			return 1.0f;
+		}
+		return loose ? loader.getCollected() / static_cast<float>(ASSET_COUNT) : 0.0f;
 	}
 
 	// clear textures handler
 	void unload()
 	{
-		for (SDL_Texture* tex : textures)
+		loader.stop();
+		for (SDL_Surface* image : decoded)
 		{
-			SDL_DestroyTexture(tex);
+			SDL_DestroySurface(image);
 		}
+		decoded.clear();
+		SDL_DestroyTexture(atlasTexture);
 	}
 };
 
 
 // forward declare funcs
+Options parseOptions(int argc, char* argv[]);
 bool initialize(SDLState& state);
 void cleanup(SDLState& state);
-void drawObject(const SDLState& state, GameState& gs, GameObject& obj, float width, float height, float deltaTime);
-void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime);
+void drawObject(GameState& gs, RenderQueue& queue, RenderLayer layer, GameObject& obj, float width, float height, float alpha);
+void simulate(const SDLState& state, GameState& gs, Resources& res, float deltaTime);
+void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime, TickOutput& out);
+void mergeTickOutput(GameState& gs, Resources& res, TickOutput& out);
+uint64_t stateChecksum(const GameState& gs);
+void saveState(const GameState& gs, SnapshotWriter& out);
+void loadState(const SDLState& state, GameState& gs, Resources& res, SnapshotReader& in);
+void findContacts(GameState& gs, FrameVector<SweepAndPrune::Pair>& contacts);
+void applyContacts(const SDLState& state, GameState& gs, Resources& res, const FrameVector<SweepAndPrune::Pair>& contacts, float deltaTime);
+void hitBullet(GameState& gs, Resources& res, GameObject& bullet);
+void createStressScene(const SDLState& state, GameState& gs, Resources& res, int count);
+void drawEnemies(GameState& gs, Resources& res, RenderQueue& queue, float alpha);
 void createTiles(const SDLState& state, GameState& gs, Resources& res);
-void checkCollision(const SDLState& state, GameState& gs, Resources& res, GameObject& a, GameObject& b, float deltaTime);
-void collisionResponse(const SDLState& state, GameState& gs, Resources& res, SDL_FRect& rectA, SDL_FRect& rectB, SDL_FRect& rectC, GameObject& objA, GameObject& objB, float deltaTime);
+size_t tileObjectBytes(const TileMap& tiles);
+std::vector<TileInfo> createTileTable(Resources& res);
+void buildLevelWindow(const SDLState& state, GameState& gs, Resources& res);
+bool streamLevel(const SDLState& state, GameState& gs, Resources& res);
+bool replayTick(SDLState& state, GameState& gs, Resources& res, InputReplay& replay);
+void checkCollision(const SDLState& state, GameState& gs, Resources& res, GameObject& a, const SDL_FRect& rectB, ObjectType typeB, float deltaTime);
+void collisionResponse(const SDLState& state, GameState& gs, Resources& res, const SDL_FRect& rectA, const SDL_FRect& rectB, const SDL_FRect& rectC, GameObject& objA, ObjectType typeB, float deltaTime);
 void handleKeyInput(const SDLState& state, GameState& gs, GameObject& obj, SDL_Scancode key, bool keyPressed);
-void drawParalaxBackground(SDL_Renderer* renderer, SDL_Texture* texture, float camDeltaX, float& scrollPos, float scrollFactor, float deltaTime);
+void createBackground(GameState& gs, Resources& res);
+FrameVector<TickOutput> batchOutputs(GameState& gs, size_t batches);
 
 int main(int argc, char* argv[])
 {
+	const uint64_t launchTime = SDL_GetTicksNS();
 	SDLState state;
 	state.height = 900;
 	state.width = 1600;
 	state.logH = 320;
 	state.logW = 640;
 
+	Options opts = parseOptions(argc, argv);
+	state.headless = opts.benchFrames > 0;
+
+	// a replay runs with the settings it was recorded with
+	InputReplay replay;
+	if (!opts.replayPath.empty())
+	{
+		if (!replay.startPlayback(opts.replayPath))
+		{
+			SDL_Log("Missing or invalid recording %s", opts.replayPath.c_str());
+			return 1;
+		}
+		opts.tickRate = static_cast<int>(replay.getTickRate());
+		opts.stress = static_cast<int>(replay.getStress());
+		SDL_Log("Replaying %u ticks from %s", replay.tickCount(), opts.replayPath.c_str());
+	}
+
 	if (!initialize(state)) {
 		return 1;
 	}
 
-	//assets
+	// vsync unless asked otherwise, F5 cycles through the modes while playing
+	FramePacer pacer;
+	pacer.setMode(state.window, state.renderer, state.headless && !opts.pacingSet ? PacingMode::uncapped : opts.pacing, opts.fpsCap);
+
+	const size_t workerCount = opts.jobs < 0 ? std::max(1u, std::thread::hardware_concurrency()) - 1 : opts.jobs;
+
+	// assets load in the background while the menu is up; headless runs go on to the game
+	// as soon as they are in
 	Resources res;
-	res.load(state);
+	res.beginLoad(opts.looseAssets, workerCount);
+	double firstFrameMs = 0;
+	LoadStatus loadStatus = LoadStatus::loading;
+	bool quit = false;
+	{
+		// scoped so the menu's cached texture goes before the renderer
+		Menu menu(state.renderer);
+		uint64_t menuTime = SDL_GetTicksNS();
+		while (!quit)
+		{
+			SDL_Event event{ 0 };
+			while (SDL_PollEvent(&event))
+			{
+				if (event.type == SDL_EVENT_QUIT)
+				{
+					quit = true;
+				}
+				menu.handleEvent(event);
+			}
+
+			const uint64_t now = SDL_GetTicksNS();
+			menu.update((now - menuTime) / 1e9f);
+			menuTime = now;
+			menu.setLoadProgress(res.loadProgress());
+			pacer.wait();
+			menu.render();
+			pacer.endFrame();
+			if (firstFrameMs == 0)
+			{
+				firstFrameMs = (SDL_GetTicksNS() - launchTime) / 1e6;
+				SDL_Log("First frame after %.2f ms", firstFrameMs);
+			}
+
+			loadStatus = res.pollLoad(state);
+			if (loadStatus == LoadStatus::failed || (loadStatus == LoadStatus::done && (state.headless || menu.shouldStartGame())))
+			{
+				break;
+			}
+		}
+	}
+	if (quit)
+	{
+		res.unload();
+		cleanup(state);
+		return 0;
+	}
+	if (loadStatus == LoadStatus::failed)
+	{
+		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", "Error loading assets", state.window);
+		res.unload();
+		cleanup(state);
+		return 1;
+	}
+	SDL_Log("Assets loaded in %.2f ms", res.loadMs);
 
 	// game data
 	GameState gs(state);
+	if (!gs.level.open(opts.levelPath, LEVEL_STREAM_RADIUS))
+	{
+		SDL_Log("Missing or invalid level %s, run the cooker", opts.levelPath.c_str());
+		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", "Error loading level", state.window);
+		res.unload();
+		cleanup(state);
+		return 1;
+	}
+	if (replay.playing() && replay.getLevelCols() != gs.level.getHeader().cols)
+	{
+		SDL_Log("Recording was made on a level %u columns wide, this one has %u", replay.getLevelCols(), gs.level.getHeader().cols);
+	}
+	if (!opts.recordPath.empty())
+	{
+		replay.startRecording(opts.recordPath, opts.tickRate, opts.stress, gs.level.getHeader().cols);
+	}
 	createTiles(state, gs, res);
-	uint64_t prevTime = SDL_GetTicks();
-	bool running = true;
+	createBackground(gs, res);
+	SDL_Log("Level tiles: %zu bytes as tile ids, %zu bytes as one GameObject per tile", gs.tiles.memoryBytes(), tileObjectBytes(gs.tiles));
+	gs.animator.reserve(MAX_BULLETS + 1 + opts.animStress + opts.stress);
+	gs.bullets.init(MAX_BULLETS, gs.animator, res.clips, res.ANIM_BULLET_MOVING);
+	createStressScene(state, gs, res, opts.stress);
+	gs.jobs.start(workerCount);
+
+	// per-frame buffers sized for their worst case up front: the characters, enemies and
+	// bullets can all be one batch of the atlas
+	gs.batch.reserve(MAX_BULLETS + 1 + gs.enemies.size());
+
+	// animations with no object attached, to measure the stepping pass at scale
+	for (int i = 0; i < opts.animStress; i++)
+	{
+		gs.animator.create(res.clips, i % static_cast<int>(res.clips.size()));
+	}
 
-	while (running)
+	// headless runs drive a scripted keyboard and a fixed 60 Hz frame clock, replays set
+	// the keys every tick instead
+	ScriptedInput script;
+	BenchStats stats;
+	FrameTimer frameTimer;
+	const int totalFrames = BENCH_WARMUP_FRAMES + opts.benchFrames;
+	int frame = 0;
+	if (state.headless)
 	{
-		uint64_t nowTime = SDL_GetTicks();
-		float deltaTime = (nowTime - prevTime) / 1000.0f;
-		SDL_Event event{ 0 };
-		while (SDL_PollEvent(&event)) {
-			switch (event.type)
+		state.keys = script.data();
+		stats.reserve(opts.benchFrames);
+		replay.reserve(static_cast<size_t>(totalFrames) * opts.maxCatchupSteps);
+	}
+	const auto clockNow = [&state, &frame]() { return state.headless ? frame * BENCH_FRAME_NS : SDL_GetTicksNS(); };
+
+	// every tick goes into a delta history of snapshots: Backspace rewinds through it, F6
+	// and F7 quick-save and load, and --rollback resimulates the newest ticks every frame
+	std::vector<uint8_t> snapshotBuffer, quickSave;
+	SnapshotHistory history(SNAPSHOT_HISTORY_TICKS, SNAPSHOT_HISTORY_BYTES);
+	std::vector<TickInput> tickInputs(SNAPSHOT_HISTORY_TICKS + 1);
+	std::array<bool, SDL_SCANCODE_COUNT> rollbackKeys{};
+	uint8_t pendingPresses = 0;
+	uint32_t windowTick = 0; // first tick simulated on the current level window
+	size_t snapshotBytes = 0;
+	uint64_t captureTicks = 0, restoreTicks = 0, rollbackTicks = 0;
+	uint64_t rollbacks = 0, rollbackMismatches = 0;
+	const auto capture = [&]() {
+		PROFILE_SCOPE("snapshot");
+		const uint64_t start = SDL_GetPerformanceCounter();
+		SnapshotWriter out(snapshotBuffer);
+		saveState(gs, out);
+		snapshotBytes = out.finish();
+		history.push(snapshotBuffer.data(), snapshotBytes);
+		captureTicks += SDL_GetPerformanceCounter() - start;
+	};
+	const auto restore = [&](const uint8_t* data) {
+		const uint64_t start = SDL_GetPerformanceCounter();
+		SnapshotReader in(data);
+		loadState(state, gs, res, in);
+		restoreTicks += SDL_GetPerformanceCounter() - start;
+	};
+	capture();
+
+	FixedStep simClock(opts.tickRate, opts.maxCatchupSteps);
+	simClock.start(clockNow());
+	bool running = true;
+
+	// with RPG_ALLOC_TRACKING every heap allocation is charged to a frame phase; after the
+	// warm-up a headless frame must not make any, unless it rebuilt the level window
+	AllocTracker& allocs = AllocTracker::instance();
+	std::array<AllocCounts, FRAME_PHASE_COUNT> allocTotals{};
+	AllocCounts lastFrameAllocs{ 0, 0 };
+	uint64_t allocatingFrames = 0;
+
+	// the fixed ticks of a frame, run on the pipeline worker; steps and rewinding are set
+	// before every kick. Nothing else touches the game state until wait() returns
+	int steps = 0;
+	bool rewinding = false;
+	const auto update = [&]() {
+		PROFILE_SCOPE("update");
+		if (rewinding)
+		{
+			// time runs backwards at the rate it would have run forwards
+			bool rewound = false;
+			for (int i = 0; i < steps && history.stepBack(); i++)
+			{
+				rewound = true;
+			}
+			if (rewound)
 			{
-			case SDL_EVENT_QUIT:
+				restore(history.newest());
+				windowTick = gs.tick;
+			}
+			pendingPresses = 0;
+		}
+		for (int i = 0; i < steps && !rewinding; i++)
+		{
+			if (replay.playing() && !replayTick(state, gs, res, replay))
 			{
 				running = false;
 				break;
 			}
-			case SDL_EVENT_WINDOW_RESIZED:
+			tickInputs[gs.tick % tickInputs.size()] = TickInput{ packReplayKeys(state.keys), pendingPresses };
+			pendingPresses = 0;
+			simulate(state, gs, res, simClock.tickSeconds());
+			capture();
+			if (replay.recording() || replay.playing())
 			{
-				state.width = event.window.data1;
-				state.height = event.window.data2;
-				break;
+				replay.endTick(gs.tick - 1, state.keys, stateChecksum(gs));
 			}
-			case SDL_EVENT_KEY_DOWN:
+		}
+
+		// restore the newest ticks' starting snapshot and simulate them again from their
+		// recorded input, the way a rollback would after a late input; the state has to come
+		// out exactly as it went in. Never across a level window change, which happens
+		// outside the ticks
+		const uint32_t rollbackDepth = std::min({ static_cast<uint32_t>(opts.rollback), static_cast<uint32_t>(history.depth()), gs.tick - windowTick });
+		if (rollbackDepth > 0 && !rewinding && !replay.playing())
+		{
+			PROFILE_SCOPE("rollback");
+			const uint64_t start = SDL_GetPerformanceCounter();
+			const uint64_t expected = stateChecksum(gs);
+			const size_t contacts = gs.contactCount, pairTests = gs.pairTests;
+			const uint64_t enemyTicks = gs.enemyUpdateTicks;
+			for (uint32_t i = 0; i < rollbackDepth; i++)
 			{
-				handleKeyInput(state, gs, gs.player(), event.key.scancode, true);
-				break;
+				history.stepBack();
 			}
-			case SDL_EVENT_KEY_UP:
+			restore(history.newest());
+			const bool* liveKeys = state.keys;
+			state.keys = rollbackKeys.data();
+			for (uint32_t i = 0; i < rollbackDepth; i++)
 			{
-				handleKeyInput(state, gs, gs.player(), event.key.scancode, false);
-				break;
+				const TickInput& input = tickInputs[gs.tick % tickInputs.size()];
+				unpackReplayKeys(input.keys, rollbackKeys.data());
+				for (size_t k = 0; k < REPLAY_KEY_COUNT; k++)
+				{
+					if (input.presses >> k & 1)
+					{
+						handleKeyInput(state, gs, gs.player(), REPLAY_KEYS[k], true);
+					}
+				}
+				simulate(state, gs, res, simClock.tickSeconds());
+				capture();
 			}
+			state.keys = liveKeys;
+			gs.contactCount = contacts;
+			gs.pairTests = pairTests;
+			gs.enemyUpdateTicks = enemyTicks;
+			rollbacks++;
+			if (stateChecksum(gs) != expected)
+			{
+				rollbackMismatches++;
+				SDL_Log("Rollback of %u ticks diverged at tick %u", rollbackDepth, gs.tick);
 			}
+			rollbackTicks = SDL_GetPerformanceCounter() - start;
 		}
+	};
+	PipelineWorker simulation;
+	simulation.start(update, opts.pipeline);
+	RenderQueue renderQueue(gs.arena);
 
-		SDL_RenderClear(state.renderer);
+	Profiler& profiler = Profiler::instance();
+	while (running)
+	{
+		const uint32_t windowBuilds = gs.windowBuilds;
+		gs.arena.beginFrame();
+		if (state.headless && !replay.playing())
+		{
+			script.apply(frame);
+		}
+		profiler.beginFrame();
+		frameTimer.begin();
+		uint64_t nowTime = clockNow();
+		SDL_Event event{ 0 };
+		{
+			PROFILE_SCOPE("events");
+			while (SDL_PollEvent(&event)) {
+				switch (event.type)
+				{
+				case SDL_EVENT_QUIT:
+				{
+					running = false;
+					break;
+				}
+				case SDL_EVENT_WINDOW_RESIZED:
+				{
+					state.width = event.window.data1;
+					state.height = event.window.data2;
+					break;
+				}
+				case SDL_EVENT_KEY_DOWN:
+				{
+					if (event.key.scancode == SDL_SCANCODE_F5)
+					{
+						pacer.cycle(state.window, state.renderer, opts.fpsCap);
+						break;
+					}
+					// profiler controls: F3 toggles the overlay, F4 saves the last frames as a
+					// trace. Handled here, outside the recorded input, so they never run on the
+					// simulation thread while the profiler is being drawn or recorded into
+					if (event.key.scancode == SDL_SCANCODE_F3)
+					{
+						profiler.toggleOverlay();
+						break;
+					}
+					if (event.key.scancode == SDL_SCANCODE_F4)
+					{
+						if (profiler.exportChromeTrace(PROFILE_CAPTURE_PATH, PROFILE_CAPTURE_FRAMES))
+						{
+							SDL_Log("Saved the last %u frames to %s", PROFILE_CAPTURE_FRAMES, PROFILE_CAPTURE_PATH);
+						}
+						break;
+					}
+					if (event.key.scancode == SDL_SCANCODE_F6 || event.key.scancode == SDL_SCANCODE_F7)
+					{
+						// a recording or replay has to see every tick exactly once
+						if (replay.recording() || replay.playing())
+						{
+							break;
+						}
+						if (event.key.scancode == SDL_SCANCODE_F6)
+						{
+							quickSave.assign(snapshotBuffer.begin(), snapshotBuffer.begin() + snapshotBytes);
+							SDL_Log("Quick-saved tick %u, %zu bytes", gs.tick, snapshotBytes);
+						}
+						else if (!quickSave.empty())
+						{
+							restore(quickSave.data());
+							history.clear();
+							capture();
+							windowTick = gs.tick;
+							SDL_Log("Quick-loaded tick %u", gs.tick);
+						}
+						break;
+					}
+					if (replay.playing())
+					{
+						break;
+					}
+					if (replay.recording())
+					{
+						replay.recordEvent(gs.tick, event.key);
+					}
+					pendingPresses |= replayKeyBit(event.key.scancode);
+					handleKeyInput(state, gs, gs.player(), event.key.scancode, true);
+					break;
+				}
+				case SDL_EVENT_KEY_UP:
+				{
+					if (replay.playing())
+					{
+						break;
+					}
+					if (replay.recording())
+					{
+						replay.recordEvent(gs.tick, event.key);
+					}
+					handleKeyInput(state, gs, gs.player(), event.key.scancode, false);
+					break;
+				}
+				}
+			}
+		}
+		frameTimer.mark(FramePhase::events);
 
-		gs.mapViewport.x = (gs.player().position.x + TILE_SIZE/2)- gs.mapViewport.w / 2;
-		static float lastCamX = gs.mapViewport.x;
-		float camDeltaX = gs.mapViewport.x - lastCamX;
-		lastCamX = gs.mapViewport.x;
+		// pick up streamed chunks before simulating on them, replays load the recorded
+		// windows tick by tick instead
+		if (!replay.playing() && streamLevel(state, gs, res))
+		{
+			windowTick = gs.tick;
+			if (replay.recording())
+			{
+				replay.recordWindow(gs.tick, gs.level.residentIndices());
+			}
+		}
 
+		// run the simulation in fixed ticks, independent of the display rate. The ticks run on
+		// the pipeline worker while this thread submits the previous frame
+		gs.enemyUpdateTicks = 0;
+		gs.contactCount = gs.pairTests = 0;
+		captureTicks = restoreTicks = rollbackTicks = 0;
+		steps = simClock.advance(nowTime);
+		rewinding = !state.headless && !replay.recording() && !replay.playing() && state.keys[SDL_SCANCODE_BACKSPACE];
+		// from here to wait() the worker owns the game state and the frame arena: simulate()
+		// rewinds the arena after every tick, so this thread must not allocate from it until
+		// the ticks are done. The previous frame's recording lives in the other buffer
+		simulation.kick();
+		gs.arena.lockOut(std::this_thread::get_id());
+
+		// the previous frame, touches no game state and allocates nothing from the arena
+		{
+			PROFILE_SCOPE("present");
+			SDL_SetRenderDrawColor(state.renderer, 200, 200, 200, 200);
+			SDL_RenderClear(state.renderer);
+			gs.batch.resetStats();
+			renderQueue.execute(state.renderer, gs.batch);
+			profiler.drawOverlay(state.renderer, state.logW - 220.0f, 5);
+			pacer.wait();
+			SDL_RenderPresent(state.renderer);
+		}
+		pacer.endFrame();
+		frameTimer.mark(FramePhase::present);
+
+		{
+			PROFILE_SCOPE("wait simulation");
+			simulation.wait();
+		}
+		gs.arena.lockOut(std::thread::id());
+		const float alpha = simClock.alpha();
+		frameTimer.mark(FramePhase::update);
+
+		// animations are purely visual, so they advance once per frame by the simulated time
+		{
+			PROFILE_SCOPE("animate");
+			const float animTime = steps * simClock.tickSeconds();
+			gs.jobs.parallelFor(gs.animator.size(), ANIM_BATCH, [&gs, animTime](size_t, size_t begin, size_t end) {
+				gs.animator.step(animTime, begin, end);
+			});
+		}
+		frameTimer.mark(FramePhase::animate);
 
-		// background
-		SDL_RenderTexture(state.renderer, res.texBg1, nullptr, nullptr);
-		SDL_RenderTexture(state.renderer, res.texBg2, nullptr, nullptr);
-		drawParalaxBackground(state.renderer, res.texBg3, camDeltaX, gs.bg3Scroll, 0.150f, deltaTime);
-		drawParalaxBackground(state.renderer, res.texBg4, camDeltaX, gs.bg4Scroll, 0.150f, deltaTime);
-		drawParalaxBackground(state.renderer, res.texBg5, camDeltaX, gs.bg5Scroll, 0.075f, deltaTime);
-		drawParalaxBackground(state.renderer, res.texBg6, camDeltaX, gs.bg6Scroll, 0.3f, deltaTime);
+		// record this frame, it is executed next frame. The camera follows the interpolated
+		// player position
+		renderQueue.begin();
+		const glm::vec2 playerPos = glm::mix(gs.player().prevPosition, gs.player().position, alpha);
+		gs.mapViewport.x = (playerPos.x + TILE_SIZE/2)- gs.mapViewport.w / 2;
 
-		// update all objects
-		for (auto& layer : gs.layers)
+		// background, a single cached copy unless a layer scrolled by a whole pixel
 		{
-			for (GameObject& obj : layer)
+			PROFILE_SCOPE("parallax");
+			gs.parallax.draw(state.renderer, renderQueue, gs.mapViewport.x, state.logW, state.logH);
+		}
+		frameTimer.mark(FramePhase::parallax);
+
+		// characters, enemies and bullets
+		gs.culler.begin(gs.mapViewport, CULL_MARGIN);
+		{
+			PROFILE_SCOPE("draw characters");
+			for (GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS])
+			{
+				drawObject(gs, renderQueue, RenderLayer::characters, obj, TILE_SIZE, TILE_SIZE, alpha);
+			}
+		}
+		uint64_t enemyDrawTicks = SDL_GetPerformanceCounter();
+		{
+			PROFILE_SCOPE("draw enemies");
+			drawEnemies(gs, res, renderQueue, alpha);
+		}
+		enemyDrawTicks = SDL_GetPerformanceCounter() - enemyDrawTicks;
+		{
+			PROFILE_SCOPE("draw bullets");
+			for (GameObject& bullet : gs.bullets)
 			{
-				update(state, gs, res, obj, deltaTime);
-				// Only animate objects that actually have animations
-				if (!obj.animations.empty() && obj.currentAnimation >= 0 && obj.currentAnimation < obj.animations.size())
+				drawObject(gs, renderQueue, RenderLayer::bullets, bullet, bullet.collider.w, bullet.collider.h, alpha);
+			}
+		}
+		frameTimer.mark(FramePhase::objects);
+
+		// level tiles, the queue puts the background behind and the foreground in front of
+		// the objects
+		{
+			PROFILE_SCOPE("draw background");
+			gs.backgroundChunks.draw(state.renderer, gs.tiles, gs.mapViewport, gs.culler, renderQueue, RenderLayer::background);
+		}
+		{
+			PROFILE_SCOPE("draw level");
+			gs.levelChunks.draw(state.renderer, gs.tiles, gs.mapViewport, gs.culler, renderQueue, RenderLayer::level);
+		}
+		{
+			PROFILE_SCOPE("draw foreground");
+			gs.foregroundChunks.draw(state.renderer, gs.tiles, gs.mapViewport, gs.culler, renderQueue, RenderLayer::foreground);
+		}
+
+		// debug info
+		renderQueue.text(5, 5, "State {}",static_cast<int> ( gs.player().data.player.state));
+		renderQueue.text(5, 20,"grounded {} velY {:.2f}", gs.player().grounded, gs.player().velocity.y);
+		renderQueue.text(5, 35, "draws {} culled {} batches {} bg overdraw {:.2f}", gs.culler.getSubmitted(), gs.culler.getCulled(), gs.batch.getDrawCalls(), gs.parallax.getOverdraw());
+		const double enemyUpdateMs = gs.enemyUpdateTicks * 1000.0 / SDL_GetPerformanceFrequency();
+		const double enemyDrawMs = enemyDrawTicks * 1000.0 / SDL_GetPerformanceFrequency();
+		renderQueue.text(5, 50, "enemies {} update {:.2f} ms draw {:.2f} ms hits {} contacts {}", gs.enemies.size(), enemyUpdateMs, enemyDrawMs, gs.playerHits, gs.contactCount);
+		const PacingStats& pacing = pacer.current();
+		renderQueue.text(5, 65, "pacing {} {:.2f} ms sd {:.2f} missed {}", pacer.modeName(), pacing.meanMs, pacing.stdDevMs(), pacing.missed);
+		const double captureMs = captureTicks * 1000.0 / SDL_GetPerformanceFrequency();
+		const double restoreMs = restoreTicks * 1000.0 / SDL_GetPerformanceFrequency();
+		renderQueue.text(5, 80, "snapshot {} KB delta {} B history {} capture {:.3f} ms restore {:.3f} ms", snapshotBytes / 1024, history.getLastDeltaBytes(), history.depth(), captureMs, restoreMs);
+		renderQueue.text(5, 95, "frame arena {} KB peak {} KB of {} KB overflows {}", gs.arena.used() / 1024, gs.arena.getHighWater() / 1024, gs.arena.getCapacity() / 1024, gs.arena.getOverflows());
+		if (allocs.enabled())
+		{
+			renderQueue.text(5, 110, "heap allocs last frame {} ({} bytes)", lastFrameAllocs.count, lastFrameAllocs.bytes);
+		}
+		frameTimer.mark(FramePhase::tiles);
+		profiler.endFrame();
+		lastFrameAllocs = allocs.frameTotal();
+
+		if (state.headless)
+		{
+			if (frame >= BENCH_WARMUP_FRAMES)
+			{
+				for (size_t i = 0; i < FRAME_PHASE_COUNT; i++)
+				{
+					allocTotals[i].count += allocs.phase(i).count;
+					allocTotals[i].bytes += allocs.phase(i).bytes;
+				}
+				if (lastFrameAllocs.count > 0 && gs.windowBuilds == windowBuilds)
+				{
+					if (allocatingFrames++ == 0)
+					{
+						for (size_t i = 0; i < FRAME_PHASE_COUNT; i++)
+						{
+							if (allocs.phase(i).count > 0)
+							{
+								SDL_Log("Frame %d allocated %llu times (%llu bytes) in %s", frame, static_cast<unsigned long long>(allocs.phase(i).count),
+									static_cast<unsigned long long>(allocs.phase(i).bytes), FRAME_PHASE_NAMES[i]);
+							}
+						}
+					}
+				}
+				stats.record(frameTimer);
+				stats.recordCounter("heap_allocs", static_cast<double>(lastFrameAllocs.count));
+				stats.recordCounter("heap_alloc_bytes", static_cast<double>(lastFrameAllocs.bytes));
+				stats.recordCounter("draws_submitted", gs.culler.getSubmitted());
+				stats.recordCounter("draws_culled", gs.culler.getCulled());
+				stats.recordCounter("batch_draw_calls", gs.batch.getDrawCalls());
+				stats.recordCounter("batch_quads", gs.batch.getQuads());
+				stats.recordCounter("parallax_overdraw", gs.parallax.getOverdraw());
+				stats.recordCounter("parallax_redraws", gs.parallax.getRedraws());
+				stats.recordCounter("enemy_update_ms", enemyUpdateMs);
+				stats.recordCounter("enemy_draw_ms", enemyDrawMs);
+				stats.recordCounter("broadphase_tests", static_cast<double>(gs.pairTests));
+				stats.recordCounter("contacts", static_cast<double>(gs.contactCount));
+				stats.recordCounter("snapshot_bytes", static_cast<double>(snapshotBytes));
+				stats.recordCounter("snapshot_delta_bytes", static_cast<double>(history.getLastDeltaBytes()));
+				stats.recordCounter("snapshot_capture_ms", captureMs);
+				stats.recordCounter("snapshot_restore_ms", restoreMs);
+				stats.recordCounter("arena_high_water", static_cast<double>(gs.arena.getHighWater()));
+				if (opts.rollback > 0)
 				{
-					obj.animations[obj.currentAnimation].step(deltaTime);
+					stats.recordCounter("rollback_ms", rollbackTicks * 1000.0 / SDL_GetPerformanceFrequency());
 				}
 			}
+			if (++frame >= totalFrames)
+			{
+				running = false;
+			}
+		}
+	}
+
+	if (state.headless)
+	{
+		std::printf("{\n  \"tick_rate\": %d,\n  \"level_cols\": %u,\n  \"asset_load_ms\": %.3f,\n  \"first_frame_ms\": %.3f,\n  ", opts.tickRate, gs.level.getHeader().cols, res.loadMs, firstFrameMs);
+		std::printf("\"tile_bytes\": %zu,\n  \"tile_object_bytes\": %zu,\n  ", gs.tiles.memoryBytes(), tileObjectBytes(gs.tiles));
+		std::printf("\"anim_instances\": %zu,\n  ", gs.animator.size());
+		std::printf("\"workers\": %zu,\n  \"characters\": %zu,\n  \"enemies\": %zu,\n  \"state_checksum\": \"%016llx\",\n  ",
+			gs.jobs.workerCount(), gs.layers[LAYER_IDX_CHARACTERS].size(), gs.enemies.size(), static_cast<unsigned long long>(stateChecksum(gs)));
+		if (replay.playing())
+		{
+			std::printf("\"replay\": {\"ticks\": %u, \"verified\": %u, \"diverged_at\": %lld},\n  ",
+				replay.tickCount(), replay.getVerified(), static_cast<long long>(replay.getDivergedAt()));
+		}
+		std::printf("\"snapshots\": {\"history_ticks\": %zu, \"history_bytes\": %zu, \"rollback_ticks\": %d, \"rollbacks\": %llu, \"rollback_mismatches\": %llu},\n  ",
+			history.depth(), history.memoryBytes(), opts.rollback, static_cast<unsigned long long>(rollbacks), static_cast<unsigned long long>(rollbackMismatches));
+		std::printf("\"allocations\": {\"tracked\": %s, \"allocating_frames\": %llu, \"phases\": {",
+			allocs.enabled() ? "true" : "false", static_cast<unsigned long long>(allocatingFrames));
+		for (size_t i = 0; i < FRAME_PHASE_COUNT; i++)
+		{
+			std::printf("%s\"%s\": {\"count\": %llu, \"bytes\": %llu}", i ? ", " : "", FRAME_PHASE_NAMES[i],
+				static_cast<unsigned long long>(allocTotals[i].count), static_cast<unsigned long long>(allocTotals[i].bytes));
 		}
-		// bullet physics
-		for (GameObject& bullet : gs.bullets)
+		std::printf("}},\n  ");
+		std::printf("\"frame_arena\": {\"capacity\": %zu, \"high_water\": %zu, \"overflows\": %llu},\n  ",
+			gs.arena.getCapacity(), gs.arena.getHighWater(), static_cast<unsigned long long>(gs.arena.getOverflows()));
+		const PacingStats& pacing = pacer.current();
+		std::printf("\"pacing\": {\"mode\": \"%s\", \"frames\": %llu, \"mean_ms\": %.4f, \"stddev_ms\": %.4f, \"worst_ms\": %.4f, \"missed\": %llu},\n  ",
+			pacer.modeName(), static_cast<unsigned long long>(pacing.frames), pacing.meanMs, pacing.stdDevMs(), pacing.worstMs, static_cast<unsigned long long>(pacing.missed));
+		stats.printJson(stdout);
+		std::printf("\n}\n");
+	}
+	else
+	{
+		for (size_t i = 0; i < PACING_MODE_COUNT; i++)
 		{
-			update(state, gs, res, bullet, deltaTime);
-			if (!bullet.animations.empty() && bullet.currentAnimation >= 0 && bullet.currentAnimation < bullet.animations.size())
+			const PacingStats& pacing = pacer.of(static_cast<PacingMode>(i));
+			if (pacing.frames)
 			{
-				bullet.animations[bullet.currentAnimation].step(deltaTime);
+				SDL_Log("Pacing %s: %llu frames, %.3f ms mean, %.3f ms stddev, %.3f ms worst, %llu missed", PACING_MODE_NAMES[i],
+					static_cast<unsigned long long>(pacing.frames), pacing.meanMs, pacing.stdDevMs(), pacing.worstMs, static_cast<unsigned long long>(pacing.missed));
 			}
 		}
+	}
 
-		// draw all objects
-		for (auto& layer : gs.layers)
+	if (replay.playing())
+	{
+		SDL_Log("Replay: %u of %u ticks matched the recording", replay.getVerified(), replay.tickCount());
+	}
+	if (allocatingFrames > 0)
+	{
+		SDL_Log("%llu steady-state frames allocated on the heap", static_cast<unsigned long long>(allocatingFrames));
+	}
+	if (replay.recording())
+	{
+		if (replay.save())
 		{
-			for (GameObject& obj : layer)
+			SDL_Log("Recorded %u ticks to %s", replay.tickCount(), opts.recordPath.c_str());
+		}
+		else
+		{
+			SDL_Log("Could not write recording %s", opts.recordPath.c_str());
+		}
+	}
+
+	if (!opts.tracePath.empty() && !profiler.exportChromeTrace(opts.tracePath.c_str(), PROFILE_CAPTURE_FRAMES))
+	{
+		SDL_Log("Could not write trace %s (profiler compiled out?)", opts.tracePath.c_str());
+	}
+
+	simulation.stop();
+	gs.jobs.stop();
+	gs.level.stop();
+	gs.levelChunks.release();
+	gs.foregroundChunks.release();
+	gs.backgroundChunks.release();
+	gs.parallax.release();
+	res.unload();
+	cleanup(state);
+	return replay.getDivergedAt() < 0 && rollbackMismatches == 0 && allocatingFrames == 0 ? 0 : 1;
+}
+
+// one fixed simulation tick
+void simulate(const SDLState& state, GameState& gs, Resources& res, float deltaTime)
+{
+	PROFILE_SCOPE("simulate");
+	// everything a tick collects is applied before it ends, so its scratch goes straight back
+	const size_t arenaMark = gs.arena.mark();
+	gs.mapViewport.x = (gs.player().position.x + TILE_SIZE/2)- gs.mapViewport.w / 2;
+
+	// the player reads input and shoots, it stays on this thread
+	TickOutput playerOutput(gs.arena);
+	{
+		PROFILE_SCOPE("player");
+		GameObject& player = gs.player();
+		player.prevPosition = player.position;
+		update(state, gs, res, player, deltaTime, playerOutput);
+	}
+
+	// every other character only writes to itself and reads the level, level tiles are static
+	// and need no tick
+	std::vector<GameObject>& characters = gs.layers[LAYER_IDX_CHARACTERS];
+	const size_t playerIndex = static_cast<size_t>(gs.playerIndex);
+	FrameVector<TickOutput> outputs = batchOutputs(gs, JobSystem::batchCount(characters.size(), ENTITY_BATCH));
+	gs.jobs.parallelFor(characters.size(), ENTITY_BATCH, [&](size_t batch, size_t begin, size_t end) {
+		PROFILE_SCOPE("characters");
+		for (size_t i = begin; i < end; i++)
+		{
+			if (i != playerIndex)
 			{
-				drawObject(state, gs, obj, TILE_SIZE, TILE_SIZE, deltaTime);
+				characters[i].prevPosition = characters[i].position;
+				update(state, gs, res, characters[i], deltaTime, outputs[batch]);
 			}
 		}
+	});
+	{
+		PROFILE_SCOPE("merge");
+		mergeTickOutput(gs, res, playerOutput);
+		for (TickOutput& out : outputs)
+		{
+			mergeTickOutput(gs, res, out);
+		}
+	}
 
-		// draw bullets
-		for (GameObject& bullet : gs.bullets)
+	// enemies react to the player as it is after its own update
+	const uint64_t enemyStart = SDL_GetPerformanceCounter();
+	const GameObject& player = gs.player();
+	const glm::vec2 target = player.position + glm::vec2(player.collider.x + player.collider.w / 2, player.collider.y + player.collider.h / 2);
+	const float floorY = static_cast<float>(state.logH);
+	outputs = batchOutputs(gs, JobSystem::batchCount(gs.enemies.size(), ENEMY_BATCH));
+	gs.jobs.parallelFor(gs.enemies.size(), ENEMY_BATCH, [&](size_t batch, size_t begin, size_t end) {
+		PROFILE_SCOPE("enemies");
+		TickOutput& out = outputs[batch];
+		gs.enemies.update(begin, end, gs.tiles, target, floorY, deltaTime, [&out](size_t, float direction) {
+			out.playerHits.push_back(direction);
+		});
+	});
+	for (TickOutput& out : outputs)
+	{
+		mergeTickOutput(gs, res, out);
+	}
+	gs.enemyUpdateTicks += SDL_GetPerformanceCounter() - enemyStart;
+
+	// bullet physics, spawned bullets move on the tick they were fired. A bullet update writes
+	// only the bullet and its own animator slot (hitBullet restarts that one animation);
+	// anything shared goes through its batch output, merged in batch order like above
+	outputs = batchOutputs(gs, JobSystem::batchCount(gs.bullets.size(), BULLET_BATCH));
+	GameObject* bullets = gs.bullets.begin();
+	gs.jobs.parallelFor(gs.bullets.size(), BULLET_BATCH, [&](size_t batch, size_t begin, size_t end) {
+		PROFILE_SCOPE("bullets");
+		for (size_t i = begin; i < end; i++)
 		{
-			drawObject(state, gs, bullet, bullet.collider.w, bullet.collider.h, deltaTime);
+			bullets[i].prevPosition = bullets[i].position;
+			update(state, gs, res, bullets[i], deltaTime, outputs[batch]);
 		}
+	});
+	for (TickOutput& out : outputs)
+	{
+		mergeTickOutput(gs, res, out);
+	}
+
+	// bullets against enemies and enemies against the player, found in one sweep and
+	// handled as one batch; whatever died goes only after every contact is applied
+	FrameVector<SweepAndPrune::Pair> contacts{ FrameAllocator<SweepAndPrune::Pair>(gs.arena) };
+	findContacts(gs, contacts);
+	applyContacts(state, gs, res, contacts, deltaTime);
+	gs.enemies.retireDead([&gs](int anim) { gs.animator.destroy(anim); });
+	gs.bullets.retireInactive();
+	gs.tick++;
+	gs.arena.rewind(arenaMark);
+}
 
-		// draw foreground tiles
-		for (GameObject& obj : gs.foregroundTiles)
+// collect this tick's candidate pairs, spent bullets no longer collide
+void findContacts(GameState& gs, FrameVector<SweepAndPrune::Pair>& contacts)
+{
+	PROFILE_SCOPE("broadphase");
+	SweepAndPrune& broadphase = gs.broadphase;
+	broadphase.clear();
+	broadphase.reserve(1 + gs.enemies.size() + gs.bullets.capacity());
+
+	const GameObject& player = gs.player();
+	broadphase.add(SDL_FRect{ player.position.x + player.collider.x, player.position.y + player.collider.y, player.collider.w, player.collider.h },
+		bodyGroup(ObjectType::player), static_cast<uint32_t>(gs.playerIndex));
+	for (size_t i = 0; i < gs.enemies.size(); i++)
+	{
+		broadphase.add(gs.enemies.bounds(i), bodyGroup(ObjectType::enemy), static_cast<uint32_t>(i));
+	}
+	const GameObject* bullets = gs.bullets.begin();
+	for (size_t i = 0; i < gs.bullets.size(); i++)
+	{
+		const GameObject& bullet = bullets[i];
+		if (bullet.data.bullet.state == BulletState::moving)
 		{
-			SDL_FRect dst{
-				.x = obj.position.x - gs.mapViewport.x,
-				.y = obj.position.y ,
-				.w = static_cast<float> (obj.texture->w),
-				.h = static_cast<float> (obj.texture->h),
-			};
-			SDL_RenderTexture(state.renderer, obj.texture, nullptr, &dst);
+			broadphase.add(SDL_FRect{ bullet.position.x + bullet.collider.x, bullet.position.y + bullet.collider.y, bullet.collider.w, bullet.collider.h },
+				bodyGroup(ObjectType::bullet), static_cast<uint32_t>(i));
 		}
+	}
+
+	// a body can touch several others, so room for the most pairs seen so far as well
+	contacts.reserve(std::max(MAX_BULLETS + 1 + gs.enemies.size(), gs.maxContacts));
+	broadphase.findPairs([&contacts](const SweepAndPrune::Pair& pair) {
+		contacts.push_back(pair);
+	});
+	gs.pairTests += broadphase.getTests();
+	gs.contactCount += contacts.size();
+	gs.maxContacts = std::max(gs.maxContacts, contacts.size());
+}
 
-		// draw background tiles
-		for (GameObject& obj : gs.backgroundTiles)
+// apply the contact batch in sweep order, so the outcome does not depend on the job split
+void applyContacts(const SDLState& state, GameState& gs, Resources& res, const FrameVector<SweepAndPrune::Pair>& contacts, float deltaTime)
+{
+	PROFILE_SCOPE("contacts");
+	GameObject* bullets = gs.bullets.begin();
+	for (const SweepAndPrune::Pair& contact : contacts)
+	{
+		if (contact.groupB == bodyGroup(ObjectType::bullet))
+		{
+			// a bullet is spent on the first enemy it touches, dead enemies stop taking hits
+			GameObject& bullet = bullets[contact.idB];
+			if (bullet.data.bullet.state != BulletState::moving || !gs.enemies.alive(contact.idA))
+			{
+				continue;
+			}
+			gs.enemies.hit(contact.idA, bullet.direction);
+			hitBullet(gs, res, bullet);
+		}
+		else
 		{
-			SDL_FRect dst{
-				.x = obj.position.x - gs.mapViewport.x,
-				.y = obj.position.y ,
-				.w = static_cast<float> (obj.texture->w),
-				.h = static_cast<float> (obj.texture->h),
-			};
-			SDL_RenderTexture(state.renderer, obj.texture, nullptr, &dst);
+			checkCollision(state, gs, res, gs.player(), gs.enemies.bounds(contact.idB), ObjectType::enemy, deltaTime);
 		}
+	}
+}
 
-		// debug info
-		SDL_SetRenderDrawColor( state.renderer, 200, 200, 200, 200);
-		SDL_RenderDebugText( state.renderer, 5, 5, std::format("State {}",static_cast<int> ( gs.player().data.player.state)).c_str() );
-		SDL_RenderDebugText( state.renderer,5, 20,std::format("grounded {} velY {:.2f}", gs.player().velocity.x, gs.player().velocity.y).c_str() );
+// stop a bullet where it hit and play the hit animation, it retires once that has run
+void hitBullet(GameState& gs, Resources& res, GameObject& bullet)
+{
+	bullet.data.bullet.state = BulletState::colliding;
+	bullet.data.bullet.hitTime = res.clips[res.ANIM_BULLET_HIT].length;
+	bullet.velocity = glm::vec2(0);
+	bullet.sprite = &res.sprBulletHit;
+	gs.animator.restart(bullet.animation, res.clips, res.ANIM_BULLET_HIT);
+}
+
+// apply the deferred writes of one update batch, always called in batch order
+void mergeTickOutput(GameState& gs, Resources& res, TickOutput& out)
+{
+	for (const BulletSpawn& shot : out.bulletSpawns)
+	{
+		// a full pool simply drops the shot
+		GameObject* bullet = gs.bullets.spawn(gs.animator, res.clips, res.ANIM_BULLET_MOVING);
+		if (bullet)
+		{
+			bullet->direction = shot.direction;
+			bullet->sprite = &res.sprBullet;
+			bullet->dynamic = false;
+
+			const float bw = res.sprBullet.rect.w, bh = res.sprBullet.rect.h;
 
-		SDL_RenderPresent(state.renderer);
-		prevTime = nowTime;
+			bullet->collider = { 0, 0, bw, bh };
+			bullet->position = shot.position;
+			bullet->prevPosition = bullet->position;
+			bullet->velocity = glm::vec2(shot.direction * 200.0f, 0);
+		}
+	}
+	for (float direction : out.playerHits)
+	{
+		// knocked up and away, the player's own update handles the rest
+		GameObject& player = gs.player();
+		player.velocity = glm::vec2(direction * player.maxSpeedX, ENEMY_KNOCKBACK_Y);
+		gs.playerHits++;
 	}
+	out.clear();
+}
 
-	res.unload();
-	cleanup(state);
-	return 0;
+// one output per batch of a parallel phase, dropped with the tick's scratch
+FrameVector<TickOutput> batchOutputs(GameState& gs, size_t batches)
+{
+	FrameVector<TickOutput> outputs{ FrameAllocator<TickOutput>(gs.arena) };
+	outputs.reserve(batches);
+	for (size_t b = 0; b < batches; b++)
+	{
+		outputs.emplace_back(gs.arena);
+	}
+	return outputs;
+}
+
+// order-sensitive hash of everything the simulation moves, equal runs give equal sums
+uint64_t stateChecksum(const GameState& gs)
+{
+	uint64_t hash = 14695981039346656037ull;
+	const auto mix = [&hash](const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+	const auto mixObject = [&mix](const GameObject& obj) {
+		mix(&obj.position, sizeof(obj.position));
+		mix(&obj.velocity, sizeof(obj.velocity));
+		mix(&obj.direction, sizeof(obj.direction));
+	};
+	for (const GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS])
+	{
+		mixObject(obj);
+	}
+	const size_t bulletCount = gs.bullets.size();
+	mix(&bulletCount, sizeof(bulletCount));
+	for (const GameObject& bullet : gs.bullets)
+	{
+		mixObject(bullet);
+	}
+	for (size_t i = 0; i < gs.enemies.size(); i++)
+	{
+		const glm::vec2 position = gs.enemies.position(i), velocity = gs.enemies.velocity(i);
+		const EnemyState enemyState = gs.enemies.state(i);
+		mix(&position, sizeof(position));
+		mix(&velocity, sizeof(velocity));
+		mix(&enemyState, sizeof(enemyState));
+	}
+	return hash;
+}
+
+// everything the simulation carries from one tick to the next as one flat snapshot, the
+// resident level window by chunk index
+void saveState(const GameState& gs, SnapshotWriter& out)
+{
+	out.write(gs.tick);
+	out.write(gs.playerHits);
+	out.write(gs.mapViewport);
+	const std::vector<LevelChunk>& chunks = gs.level.chunks();
+	out.write(static_cast<uint32_t>(chunks.size()));
+	for (const LevelChunk& chunk : chunks)
+	{
+		out.write(static_cast<int32_t>(chunk.index));
+	}
+	out.writeVector(gs.spawnedChunks);
+	for (const std::vector<GameObject>& layer : gs.layers)
+	{
+		out.writeVector(layer);
+	}
+	gs.bullets.save(out);
+	gs.enemies.save(out);
+	gs.animator.save(out);
+}
+
+// the window is rebuilt first when it differs, enemies it spawns are then overwritten
+void loadState(const SDLState& state, GameState& gs, Resources& res, SnapshotReader& in)
+{
+	in.read(gs.tick);
+	in.read(gs.playerHits);
+	in.read(gs.mapViewport);
+	in.readVector(gs.restoredWindow);
+	const std::vector<LevelChunk>& chunks = gs.level.chunks();
+	const bool sameWindow = std::equal(gs.restoredWindow.begin(), gs.restoredWindow.end(), chunks.begin(), chunks.end(),
+		[](int32_t index, const LevelChunk& chunk) { return index == chunk.index; });
+	if (!sameWindow)
+	{
+		gs.level.loadChunks(gs.restoredWindow);
+		buildLevelWindow(state, gs, res);
+	}
+	in.readVector(gs.spawnedChunks);
+	for (std::vector<GameObject>& layer : gs.layers)
+	{
+		in.readVector(layer);
+	}
+	gs.bullets.load(in);
+	gs.enemies.load(in);
+	gs.animator.load(in);
+}
+
+// command line parser
+Options parseOptions(int argc, char* argv[])
+{
+	Options opts;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (arg == "--tick-rate" && hasValue)
+		{
+			opts.tickRate = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--max-catchup" && hasValue)
+		{
+			opts.maxCatchupSteps = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--bench" && hasValue)
+		{
+			opts.benchFrames = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--level" && hasValue)
+		{
+			opts.levelPath = argv[++i];
+		}
+		else if (arg == "--anim-stress" && hasValue)
+		{
+			opts.animStress = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--trace" && hasValue)
+		{
+			opts.tracePath = argv[++i];
+		}
+		else if (arg == "--jobs" && hasValue)
+		{
+			opts.jobs = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--stress" && hasValue)
+		{
+			opts.stress = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--loose-assets")
+		{
+			opts.looseAssets = true;
+		}
+		else if (arg == "--pacing" && hasValue)
+		{
+			if (parsePacingMode(argv[++i], opts.pacing))
+			{
+				opts.pacingSet = true;
+			}
+			else
+			{
+				SDL_Log("Unknown pacing mode %s, expected vsync, adaptive, cap or uncapped", argv[i]);
+			}
+		}
+		else if (arg == "--fps" && hasValue)
+		{
+			opts.fpsCap = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--record" && hasValue)
+		{
+			opts.recordPath = argv[++i];
+		}
+		else if (arg == "--replay" && hasValue)
+		{
+			opts.replayPath = argv[++i];
+		}
+		else if (arg == "--no-pipeline")
+		{
+			opts.pipeline = false;
+		}
+		else if (arg == "--rollback" && hasValue)
+		{
+			opts.rollback = std::clamp(std::atoi(argv[++i]), 0, static_cast<int>(SNAPSHOT_HISTORY_TICKS));
+		}
+	}
+	return opts;
 }
 
 // initialize main parameters
 bool initialize(SDLState& state) {
 	bool initSucces = true;
 
+	// no display or GPU needed: offscreen video with the software renderer
+	if (state.headless)
+	{
+		SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen,dummy");
+	}
+
 	if (!SDL_Init(SDL_INIT_VIDEO)) {
 		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", "Erro initializing SDL3", nullptr);
 		initSucces = false;
@@ -292,14 +1422,12 @@ bool initialize(SDLState& state) {
 	}
 
 	// renderer
-	state.renderer = SDL_CreateRenderer(state.window, nullptr);
+	state.renderer = SDL_CreateRenderer(state.window, state.headless ? SDL_SOFTWARE_RENDERER : nullptr);
 	if (!state.renderer) {
 		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", "Erro initializing renderer", state.window);
 		cleanup(state);
 		initSucces = false;
 	}
-	SDL_SetRenderVSync(state.renderer, 1);
-
 	// window presentatiton
 	SDL_SetRenderLogicalPresentation(state.renderer, state.logW, state.logH, SDL_LOGICAL_PRESENTATION_STRETCH);
 	return initSucces;
@@ -313,8 +1441,12 @@ void cleanup(SDLState& state) {
 }
 
 // draw screen object handler
-void drawObject(const SDLState& state, GameState& gs, GameObject& obj, float width, float height, float deltaTime)
+void drawObject(GameState& gs, RenderQueue& queue, RenderLayer layer, GameObject& obj, float width, float height, float alpha)
 {
+	if (!obj.sprite || !obj.sprite->texture)
+	{
+		return;
+	}
 
 	SDL_FRect src{
 		.x = 0,
@@ -323,25 +1455,33 @@ void drawObject(const SDLState& state, GameState& gs, GameObject& obj, float wid
 		.h = height
 	};
 
-	if (!obj.animations.empty() && obj.currentAnimation >= 0 && obj.currentAnimation < obj.animations.size())
+	if (obj.animation >= 0)
 	{
-		src.x = obj.animations[obj.currentAnimation].currentFrame() * width;
+		// sheets with fewer frames than the animation wrap instead of sampling a neighbouring sprite
+		const int sheetFrames = std::max(1, static_cast<int>(obj.sprite->rect.w / width));
+		src.x = (gs.animator.frame(obj.animation) % sheetFrames) * width;
 	}
 
+	// blend between the last two simulation ticks
+	const glm::vec2 position = glm::mix(obj.prevPosition, obj.position, alpha);
+	if (!gs.culler.visible(SDL_FRect{ position.x, position.y, width, height }))
+	{
+		return;
+	}
 	SDL_FRect dst{
-		.x = obj.position.x - gs.mapViewport.x,
-		.y = obj.position.y,
+		.x = position.x - gs.mapViewport.x,
+		.y = position.y,
 		.w = width,
 		.h = height
 	};
 
-	SDL_FlipMode flipMode = obj.direction == 1 ? SDL_FLIP_NONE : SDL_FLIP_HORIZONTAL;
-
-	SDL_RenderTextureRotated( state.renderer, obj.texture, &src, &dst, 0, nullptr, flipMode );
+	queue.add(layer, *obj.sprite, src, dst, obj.direction != 1);
 }
 
 // synch handler
-void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime)
+// runs on job threads for everything but the player: write only to obj, queue anything
+// shared in out
+void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime, TickOutput& out)
 {
 	if(obj.dynamic)
 	{
@@ -392,32 +1532,14 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 				{
 					weaponTimer.reset();
 
-					GameObject bullet;
-					bullet.type = ObjectType::bullet;
-					bullet.direction = obj.direction;
-					bullet.texture = res.texBullet;
-					bullet.currentAnimation = res.ANIM_BULLET_MOVING;
-					bullet.dynamic = false;
-
-					float bw, bh;
-					SDL_GetTextureSize(res.texBullet, &bw, &bh);
-
-					bullet.collider = { 0, 0, bw, bh };
-
-					bullet.position = obj.position + glm::vec2(
-						obj.direction > 0 ? obj.collider.w : -bw,
-						4.0f
-					);
-
-					bullet.velocity = glm::vec2(obj.direction * 200.0f, 0);
-					bullet.animations = res.bulletAnims;
-
-					gs.bullets.push_back(bullet);
-	
-
+					const float bw = res.sprBullet.rect.w;
+					out.bulletSpawns.push_back(BulletSpawn{
+						obj.position + glm::vec2(obj.direction > 0 ? obj.collider.w : -bw, 4.0f),
+						obj.direction
+					});
 				}
-			obj.texture = res.texIdle;
-			obj.currentAnimation = res.ANIM_PLAYER_IDLE;
+			obj.sprite = &res.sprIdle;
+			gs.animator.play(obj.animation, res.clips, res.ANIM_PLAYER_IDLE);
 			break;
 			}
 			case PlayerState::running:
@@ -428,20 +1550,20 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 				}
 				if (obj.velocity.x * obj.direction < 0 && obj.grounded)
 				{
-					obj.texture = res.texSlide;
-					obj.currentAnimation = res.ANIM_PLAYER_SLIDE;
+					obj.sprite = &res.sprSlide;
+					gs.animator.play(obj.animation, res.clips, res.ANIM_PLAYER_SLIDE);
 				}
 				else
 				{
-					obj.texture = res.texRun;
-					obj.currentAnimation = res.ANIM_PLAYER_RUNNING;
+					obj.sprite = &res.sprRun;
+					gs.animator.play(obj.animation, res.clips, res.ANIM_PLAYER_RUNNING);
 				}
 				break;
 			}
 			case PlayerState::jumping:
 			{
-				obj.texture = res.texRun;
-				obj.currentAnimation = res.ANIM_PLAYER_RUNNING;
+				obj.sprite = &res.sprRun;
+				gs.animator.play(obj.animation, res.clips, res.ANIM_PLAYER_RUNNING);
 				break;
 			}
 		}
@@ -450,96 +1572,76 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 		{
 			obj.velocity.x = currentDirection * obj.maxSpeedX;
 		}
-		obj.position += obj.velocity * deltaTime;
-
-		bool foundGround = false;
 
-		for (auto& layer : gs.layers)
 		{
-			for (GameObject& objB : layer)
-			{
-				if (&obj != &objB)
-				{
-					checkCollision(state, gs, res, obj, objB, deltaTime);
-
-					SDL_FRect sensor
-					{
-						.x = obj.position.x + obj.collider.x,
-						.y = obj.position.y + obj.collider.y + obj.collider.h,
-						.w = obj.collider.w,
-						.h = 1
-					};
-					SDL_FRect rectB{
-						.x = objB.position.x + objB.collider.x,
-						.y = objB.position.y + objB.collider.y,
-						.w = objB.collider.w,
-						.h = objB.collider.h,
-					};
-
-					if (SDL_HasRectIntersectionFloat(&sensor, &rectB))
-					{
-						foundGround = true;
-					}
-				}
-			}
-			if (obj.grounded != foundGround)
-			{
-				obj.grounded = foundGround;
-			}
-			if (obj.type == ObjectType::player &&obj.data.player.state == PlayerState::jumping && obj.grounded && obj.velocity.y >= 0)
-			{
-				obj.data.player.state = PlayerState::running;
-			}
-
-
+			PROFILE_SCOPE("collision");
+			// swept against the level, gravity pushes into the floor every tick so standing
+			// on it shows up as a landing
+			const MoveResult move = moveBox(gs.tiles, LEVEL_LAYER_SOLID, obj.collider, obj.position, obj.velocity, deltaTime);
+			obj.position = move.position;
+			obj.velocity = move.velocity;
+			obj.grounded = move.grounded;
+		}
+		if (obj.data.player.state == PlayerState::jumping && obj.grounded && obj.velocity.y >= 0)
+		{
+			obj.data.player.state = PlayerState::running;
+		}
+	}
+	if (obj.type == ObjectType::bullet && obj.data.bullet.state == BulletState::colliding)
+	{
+		obj.data.bullet.hitTime -= deltaTime;
+		if (obj.data.bullet.hitTime <= 0)
+		{
+			obj.data.bullet.state = BulletState::inactive;
 		}
 	}
-	if (obj.type == ObjectType::bullet)
+	else if (obj.type == ObjectType::bullet)
 	{
-		obj.position += obj.velocity * deltaTime;
+		// swept, so a long tick cannot carry a bullet past a cell; it stops at the contact
+		// and plays its hit there
+		const MoveResult move = moveBox(gs.tiles, LEVEL_LAYER_SOLID, obj.collider, obj.position, obj.velocity, deltaTime);
+		obj.position = move.position;
+		if (move.blocked)
+		{
+			hitBullet(gs, res, obj);
+			return;
+		}
+
+		// retire bullets that left the screen
+		SDL_FRect rectA{
+			.x = obj.position.x + obj.collider.x,
+			.y = obj.position.y + obj.collider.y,
+			.w = obj.collider.w,
+			.h = obj.collider.h
+		};
+		if (!SDL_HasRectIntersectionFloat(&rectA, &gs.mapViewport))
+		{
+			obj.data.bullet.state = BulletState::inactive;
+		}
 	}
 
 
 }
 
-// collision handler
-void collisionResponse(const SDLState& state, GameState& gs, Resources& res, SDL_FRect& rectA, SDL_FRect& rectB, SDL_FRect& rectC, GameObject& objA, GameObject& objB, float deltaTime)
+// collision handler for overlaps between dynamic objects, the level is resolved by moveBox
+void collisionResponse(const SDLState& state, GameState& gs, Resources& res, const SDL_FRect& rectA, const SDL_FRect& rectB, const SDL_FRect& rectC, GameObject& objA, ObjectType typeB, float deltaTime)
 {
 	if (objA.type == ObjectType::player) 
 	{
-		switch (objB.type)
+		switch (typeB)
 		{
-			case ObjectType::level:
+			case ObjectType::enemy:
 			{
-				if (rectC.w < rectC.h)
-				{
-					if (rectA.x < rectB.x)
-						objA.position.x -= rectC.w; 
-					else
-						objA.position.x += rectC.w;  
-
-					//objA.velocity.x = 0; possible stutter when moving
-				}
-
-				else
-				{
-					if (objA.velocity.y > 0)
-					{
-						objA.position.y -= rectC.h;
-					}
-					else if(objA.velocity.y < 0)
-					{
-						objA.position.y += rectC.h;
-					}
-					objA.velocity.y = 0;
-				 }
+				// enemies hold their ground, the player is only pushed out sideways
+				objA.position.x += rectA.x < rectB.x ? -rectC.w : rectC.w;
+				break;
 			}
 		}
 	}
 }
 
-// collision box detector
-void checkCollision(const SDLState& state, GameState& gs, Resources& res, GameObject &a, GameObject &b, float deltaTime) 
+// collision box detector, rectB is the world collider of whatever a ran into
+void checkCollision(const SDLState& state, GameState& gs, Resources& res, GameObject &a, const SDL_FRect& rectB, ObjectType typeB, float deltaTime) 
 {
 	SDL_FRect rectA
 	{
@@ -547,20 +1649,103 @@ void checkCollision(const SDLState& state, GameState& gs, Resources& res, GameOb
 		.w = a.collider.w, .h = a.collider.h
 
 	};
-	SDL_FRect rectB
-	{
-		.x = b.position.x + b.collider.x, .y = b.position.y + b.collider.y,
-		.w = b.collider.w, .h = b.collider.h
-	};
 	SDL_FRect rectC{0};
 	if (SDL_GetRectIntersectionFloat(&rectA, &rectB, &rectC))
 	{
-		collisionResponse(state, gs, res, rectA, rectB, rectC, a, b, deltaTime);
+		collisionResponse(state, gs, res, rectA, rectB, rectC, a, typeB, deltaTime);
 	}
 }
 
-// tile set handler
+// background layers back to front; bg1 and bg2 do not scroll and get merged once
+void createBackground(GameState& gs, Resources& res)
+{
+	gs.parallax.addLayer(res.sprBg1, 0);
+	gs.parallax.addLayer(res.sprBg2, 0);
+	gs.parallax.addLayer(res.sprBg3, 0.150f);
+	gs.parallax.addLayer(res.sprBg4, 0.150f);
+	gs.parallax.addLayer(res.sprBg5, 0.075f);
+	gs.parallax.addLayer(res.sprBg6, 0.3f);
+}
+
+// tile set handler: spawn the player and bring in the level around it
 void createTiles(const SDLState& state, GameState& gs, Resources& res)
+{
+	const LevelHeader& header = gs.level.getHeader();
+	const int r = header.spawnRow;
+	const int c = header.spawnCol;
+
+	GameObject player;
+	player.type = ObjectType::player;
+	player.position = glm::vec2(
+		c * TILE_SIZE,
+		state.logH - (static_cast<int>(header.rows) - r) * TILE_SIZE
+	);
+	player.prevPosition = player.position;
+	player.data.player = PlayerData();
+	player.sprite = &res.sprIdle;
+	player.animation = gs.animator.create(res.clips, res.ANIM_PLAYER_IDLE);
+	player.acceleration = glm::vec2(300, 0);
+	player.maxSpeedX = 100;
+	player.dynamic = true;
+	player.collider = {
+		.x = 6,
+		.y = 6,
+		.w = 20,
+		.h = 26
+	};
+	gs.layers[LAYER_IDX_CHARACTERS].push_back(player);
+	gs.playerIndex = gs.layers[LAYER_IDX_CHARACTERS].size() - 1;
+	assert(gs.playerIndex != -1);
+
+	// the first window is read synchronously, everything after that streams in
+	gs.tiles.setTable(createTileTable(res));
+	gs.spawnedChunks.assign(levelChunkCount(header), false);
+	gs.level.loadAround(c / static_cast<int>(header.chunkCols));
+	buildLevelWindow(state, gs, res);
+	gs.level.start();
+}
+
+// enemies spread over the resident start of the level, for scaling tests;
+// positions come from a fixed seed so every run starts the same
+void createStressScene(const SDLState& state, GameState& gs, Resources& res, int count)
+{
+	gs.enemies.reserve(gs.enemies.size() + count);
+	const float spanX = std::max(gs.tiles.getCols() - 1, 1) * static_cast<float>(TILE_SIZE);
+	uint32_t seed = 0x2545F491u;
+	const auto next = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / static_cast<float>(1u << 24);
+	};
+	for (int i = 0; i < count; i++)
+	{
+		const float x = gs.tiles.cellX(0) + next() * spanX;
+		const float y = next() * state.logH * 0.5f;
+		const float direction = next() < 0.5f ? -1.0f : 1.0f;
+		gs.enemies.spawn(x, y, direction, gs.animator.create(res.clips, res.ANIM_PLAYER_RUNNING));
+	}
+}
+
+// enemies share the player's sheets until they get their own art
+void drawEnemies(GameState& gs, Resources& res, RenderQueue& queue, float alpha)
+{
+	const float size = static_cast<float>(TILE_SIZE);
+	const int sheetFrames = std::max(1, static_cast<int>(res.sprRun.rect.w / size));
+	for (size_t i = 0; i < gs.enemies.size(); i++)
+	{
+		const glm::vec2 position = glm::mix(gs.enemies.prevPosition(i), gs.enemies.position(i), alpha);
+		if (!gs.culler.visible(SDL_FRect{ position.x, position.y, size, size }))
+		{
+			continue;
+		}
+		const Sprite& sprite = gs.enemies.state(i) == EnemyState::attack ? res.sprIdle : res.sprRun;
+		const SDL_FRect src{ (gs.animator.frame(gs.enemies.anim(i)) % sheetFrames) * size, 0, size, size };
+		const SDL_FRect dst{ position.x - gs.mapViewport.x, position.y, size, size };
+		queue.add(RenderLayer::enemies, sprite, src, dst, gs.enemies.direction(i) != 1);
+	}
+}
+
+// per-id tile info, ids are the ones stored in level files
+std::vector<TileInfo> createTileTable(Resources& res)
 {
 	/*
 	1 Grass
@@ -569,117 +1754,107 @@ void createTiles(const SDLState& state, GameState& gs, Resources& res)
 	4 Left Corner
 	5 Right Corner Connect
 	6 Left Corner Connect
-	7  Player
 	*/
-	short map[MAP_ROWS][MAP_COLS] = {
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 4, 1, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 1, 1, 1, 1, 1, 3, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{1, 6, 2, 5, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 6, 2, 2, 2, 2, 2, 5, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
-	};
-	short foreground[MAP_ROWS][MAP_COLS] = {
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
-	};
-	short background[MAP_ROWS][MAP_COLS] = {
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
-		{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }
+	const SDL_FRect full{ .x = 0, .y = 0, .w = TILE_SIZE, .h = TILE_SIZE };
+	return {
+		{ nullptr, {}, false },
+		{ &res.sprGrass, full, true },
+		{ &res.sprDeepGrass, full, true },
+		{ &res.sprGrassR, full, true },
+		{ &res.sprGrassL, full, true },
+		{ &res.sprGrassConR, full, true },
+		{ &res.sprGrassConL, full, true },
 	};
+}
 
-	const auto loadMap = [&state, &gs, &res](short layer[MAP_ROWS][MAP_COLS])
+// copy the resident chunks into the tile map and rebuild the chunk caches
+void buildLevelWindow(const SDLState& state, GameState& gs, Resources& res)
+{
+	const LevelHeader& header = gs.level.getHeader();
+	const std::vector<LevelChunk>& chunks = gs.level.chunks();
+	const int rows = static_cast<int>(header.rows);
+	const int chunkCols = static_cast<int>(header.chunkCols);
+	const float originY = static_cast<float>(state.logH - rows * TILE_SIZE);
+
+	// resident chunks are sorted, gaps between them stay empty
+	const int firstCol = chunks.empty() ? 0 : chunks.front().index * chunkCols;
+	const int windowCols = chunks.empty() ? 0 : (chunks.back().index + 1) * chunkCols - firstCol;
+	gs.tiles.resize(LEVEL_LAYERS, rows, windowCols, firstCol, TILE_SIZE, originY);
+	for (const LevelChunk& chunk : chunks)
+	{
+		const int chunkCol = chunk.index * chunkCols - firstCol;
+		const bool spawnEnemies = !gs.spawnedChunks[chunk.index];
+		gs.spawnedChunks[chunk.index] = true;
+		for (int layer = 0; layer < LEVEL_LAYERS; layer++)
 		{
-			const auto createObject = [&state](int r, int c, SDL_Texture* tex, ObjectType type)
-				{
-					GameObject o;
-					o.type = type;
-					o.position = glm::vec2(c * TILE_SIZE, state.logH - (MAP_ROWS - r) * TILE_SIZE);
-					o.texture = tex;
-					o.collider = { .x = 0, .y = 0, .w = TILE_SIZE, .h = TILE_SIZE };
-					return o;
-				};
-
-			for (int r = 0; r < MAP_ROWS; r++)
+			for (int r = 0; r < rows; r++)
 			{
-				for (int c = 0; c < MAP_COLS; c++)
+				for (int c = 0; c < chunkCols; c++)
 				{
-					switch (layer[r][c])
-					{
-					case 1:
-					{
-						GameObject o = createObject(r, c, res.texGrass, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 2:
+					const int16_t tile = chunk.at(header, layer, r, c);
+					if (tile == LEVEL_TILE_ENEMY)
 					{
-						GameObject o = createObject(r, c, res.texDeepGrass, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 3:
-					{
-						GameObject o = createObject(r, c, res.texGrassR, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 4:
-					{
-						GameObject o = createObject(r, c, res.texGrassL, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 5:
-					{
-						GameObject o = createObject(r, c, res.texGrassConR, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 6:
-					{
-						GameObject o = createObject(r, c, res.texGrassConL, ObjectType::level);
-						gs.layers[LAYER_IDX_LEVEL].push_back(o);;
-						break;
-					}
-					case 7:
-					{
-						GameObject player = createObject(r, c, res.texIdle, ObjectType::player);
-						player.position = glm::vec2(
-							c * TILE_SIZE,
-							state.logH - (MAP_ROWS - r) * TILE_SIZE
-						);
-						player.data.player = PlayerData();
-						player.texture = res.texIdle;
-						player.animations = res.playerAnims;
-						player.currentAnimation = res.ANIM_PLAYER_IDLE;
-						player.acceleration = glm::vec2(300, 0);
-						player.maxSpeedX = 100;
-						player.dynamic = true;
-						player.collider = {
-							.x = 6,
-							.y = 6,
-							.w = 20,
-							.h = 26
-						};
-						gs.layers[LAYER_IDX_CHARACTERS].push_back(player);
-						gs.playerIndex = gs.layers[LAYER_IDX_CHARACTERS].size() - 1;
-						break;
-					}
+						// markers spawn once, enemies outlive their chunk being streamed out
+						if (spawnEnemies && layer == LEVEL_LAYER_SOLID)
+						{
+							const float x = static_cast<float>((chunk.index * chunkCols + c) * TILE_SIZE);
+							const float y = static_cast<float>(state.logH - (rows - r) * TILE_SIZE);
+							gs.enemies.spawn(x, y, -1.0f, gs.animator.create(res.clips, res.ANIM_PLAYER_RUNNING));
+						}
+						continue;
 					}
+					gs.tiles.set(layer, r, chunkCol + c, tile);
 				}
 			}
-		};
-	loadMap(map);
-	loadMap(foreground);
-	loadMap(background);
-	assert(gs.playerIndex != -1);
+		}
+	}
+
+	gs.windowBuilds++;
+
+	// chunks that stayed resident keep their baked textures
+	gs.levelChunks.build(gs.tiles, LEVEL_LAYER_SOLID, chunkCols);
+	gs.foregroundChunks.build(gs.tiles, LEVEL_LAYER_FOREGROUND, chunkCols);
+	gs.backgroundChunks.build(gs.tiles, LEVEL_LAYER_BACKGROUND, chunkCols);
+}
+
+// memory the same tiles took as one GameObject each plus a cell -> object index grid,
+// for comparing against TileMap::memoryBytes
+size_t tileObjectBytes(const TileMap& tiles)
+{
+	return tiles.occupied() * sizeof(GameObject) + static_cast<size_t>(tiles.getRows()) * tiles.getCols() * sizeof(int);
+}
 
+// keep the streamed window centered on the player, true when it was rebuilt
+bool streamLevel(const SDLState& state, GameState& gs, Resources& res)
+{
+	const int center = static_cast<int>(std::floor(gs.player().position.x / (gs.level.getHeader().chunkCols * TILE_SIZE)));
+	if (gs.level.update(center))
+	{
+		buildLevelWindow(state, gs, res);
+		return true;
+	}
+	return false;
+}
+
+// hand the recorded input of the next tick to the paths live input takes: key events to
+// handleKeyInput, window changes to buildLevelWindow and held keys to state.keys. False
+// once the recording has run out
+bool replayTick(SDLState& state, GameState& gs, Resources& res, InputReplay& replay)
+{
+	if (replay.finished(gs.tick))
+	{
+		return false;
+	}
+	replay.eventsFor(gs.tick, [&state, &gs](SDL_Scancode key, bool down) {
+		handleKeyInput(state, gs, gs.player(), key, down);
+	});
+	if (const ReplayWindow* window = replay.windowFor(gs.tick))
+	{
+		gs.level.loadChunks(window->chunks);
+		buildLevelWindow(state, gs, res);
+	}
+	state.keys = replay.keysFor(gs.tick);
+	return true;
 }
 
 // input listener
@@ -711,22 +1886,3 @@ void handleKeyInput(const SDLState& state, GameState& gs, GameObject& obj, SDL_S
 		}
 	}
 }
-
-
-// handle the paralax background
-void drawParalaxBackground(SDL_Renderer* renderer, SDL_Texture* texture, float camDeltaX, float& scrollPos, float scrollFactor, float deltaTime)
-{
-	scrollPos -= camDeltaX * scrollFactor;
-
-	if (scrollPos <= -texture->w)
-		scrollPos += texture->w;
-
-	SDL_FRect dst{
-		scrollPos,
-		0,
-		texture->w * 2.0f,
-		(float)texture->h
-	};
-
-	SDL_RenderTextureTiled(renderer, texture, nullptr, 1, &dst);
-}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// heap allocation counter. With RPG_ALLOC_TRACKING alloctrack.cpp replaces the global
+// operator new and every allocation is counted, by any thread; FrameTimer marks charge
+// what was allocated since the previous mark to the phase being marked, the same way it
+// charges time. Without it nothing is counted and enabled() is false.
+
+const size_t ALLOC_MAX_PHASES = 16;
+
+struct AllocCounts
+{
+	uint64_t count, bytes;
+};
+
+#ifdef RPG_ALLOC_TRACKING
+#include <atomic>
+#include <array>
+
+class AllocTracker {
+	std::atomic<uint64_t> pendingCount, pendingBytes; // since the last mark
+	std::array<AllocCounts, ALLOC_MAX_PHASES> frame;   // main thread only
+
+	static bool& threadIgnored()
+	{
+		thread_local bool ignored = false;
+		return ignored;
+	}
+
+	AllocCounts take()
+	{
+		return AllocCounts{ pendingCount.exchange(0, std::memory_order_relaxed), pendingBytes.exchange(0, std::memory_order_relaxed) };
+	}
+
+public:
+	constexpr AllocTracker() : pendingCount(0), pendingBytes(0), frame{} {}
+
+	static AllocTracker& instance()
+	{
+		static AllocTracker tracker;
+		return tracker;
+	}
+
+	static constexpr bool enabled() { return true; }
+
+	// called from operator new
+	void onAlloc(size_t size)
+	{
+		if (!threadIgnored())
+		{
+			pendingCount.fetch_add(1, std::memory_order_relaxed);
+			pendingBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+
+	// for background threads whose work is not part of any frame, like file streaming
+	static void ignoreThisThread() { threadIgnored() = true; }
+
+	// allocations before the frame started are dropped
+	void beginFrame()
+	{
+		take();
+		frame.fill(AllocCounts{ 0, 0 });
+	}
+
+	void mark(size_t phase)
+	{
+		const AllocCounts since = take();
+		frame[phase].count += since.count;
+		frame[phase].bytes += since.bytes;
+	}
+
+	AllocCounts phase(size_t phase) const { return frame[phase]; }
+	AllocCounts frameTotal() const
+	{
+		AllocCounts total{ 0, 0 };
+		for (const AllocCounts& counts : frame)
+		{
+			total.count += counts.count;
+			total.bytes += counts.bytes;
+		}
+		return total;
+	}
+};
+
+#else
+
+class AllocTracker {
+public:
+	static AllocTracker& instance()
+	{
+		static AllocTracker tracker;
+		return tracker;
+	}
+	static constexpr bool enabled() { return false; }
+	static void ignoreThisThread() {}
+	void beginFrame() {}
+	void mark(size_t) {}
+	AllocCounts phase(size_t) const { return AllocCounts{ 0, 0 }; }
+	AllocCounts frameTotal() const { return AllocCounts{ 0, 0 }; }
+};
+
+#endif
@@ -1,25 +1,124 @@
 #pragma once
-#include "timer.h"
+#include <vector>
+#include <algorithm>
+#include "snapshot.h"
 
-class Animation {
-	Timer timer;
+// immutable clip definition, shared by every instance that plays it
+struct AnimationClip
+{
 	int frameCount;
+	float length;
+	float framesPerSecond; // frameCount / length, so sampling a frame is a multiply
+
+	AnimationClip(int frameCount, float length)
+		: frameCount(frameCount), length(length), framesPerSecond(length > 0 ? frameCount / length : 0) {}
+};
+
+// every playing animation as parallel arrays; an instance is a clip id and the time
+// into it, plus the clip values step() and frame() need so neither chases the clip table
+class Animator {
+	std::vector<int> clips;
+	std::vector<float> times, lengths, framesPerSecond;
+	std::vector<int> frameCounts;
+	std::vector<int> freeSlots;
 
 public:
-	Animation() : timer(0), frameCount(0) {}
-	Animation(int frameCount, float length) : frameCount(frameCount), timer(length)
+	void reserve(size_t count)
+	{
+		clips.reserve(count);
+		times.reserve(count);
+		lengths.reserve(count);
+		framesPerSecond.reserve(count);
+		frameCounts.reserve(count);
+		freeSlots.reserve(count);
+	}
+
+	// new instance playing clip from the start, freed slots are reused first
+	int create(const std::vector<AnimationClip>& table, int clip)
+	{
+		int instance;
+		if (!freeSlots.empty())
+		{
+			instance = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			instance = static_cast<int>(clips.size());
+			clips.push_back(-1);
+			times.push_back(0);
+			lengths.push_back(0);
+			framesPerSecond.push_back(0);
+			frameCounts.push_back(1);
+		}
+		restart(instance, table, clip);
+		return instance;
+	}
+
+	// the slot keeps stepping harmlessly until it is handed out again
+	void destroy(int instance)
+	{
+		freeSlots.push_back(instance);
+	}
+
+	// switch clip, the time only resets when the clip actually changes
+	void play(int instance, const std::vector<AnimationClip>& table, int clip)
+	{
+		if (clips[instance] != clip)
+		{
+			restart(instance, table, clip);
+		}
+	}
+
+	void restart(int instance, const std::vector<AnimationClip>& table, int clip)
+	{
+		const AnimationClip& def = table[clip];
+		clips[instance] = clip;
+		times[instance] = 0;
+		lengths[instance] = def.length;
+		framesPerSecond[instance] = def.framesPerSecond;
+		frameCounts[instance] = std::max(def.frameCount, 1);
+	}
+
+	// advance instances [begin, end) at once, branch-free so the loop vectorizes;
+	// disjoint ranges can be stepped from different threads
+	void step(float deltaTime, size_t begin, size_t end)
 	{
+		float* time = times.data();
+		const float* length = lengths.data();
+		for (size_t i = begin; i < end; i++)
+		{
+			const float t = time[i] + deltaTime;
+			time[i] = t >= length[i] ? t - length[i] : t;
+		}
+	}
 
+	int frame(int instance) const
+	{
+		const int frame = static_cast<int>(times[instance] * framesPerSecond[instance]);
+		return std::min(frame, frameCounts[instance] - 1);
 	}
 
-	float getLength() const { return timer.getLength(); }
-	int currentFrame() const
+	void save(SnapshotWriter& out) const
 	{
-		return static_cast<int>(timer.getTime() / timer.getLength() * frameCount);
+		out.writeVector(clips);
+		out.writeVector(times);
+		out.writeVector(lengths);
+		out.writeVector(framesPerSecond);
+		out.writeVector(frameCounts);
+		out.writeVector(freeSlots);
 	}
 
-	void step(float deltaTime)
+	void load(SnapshotReader& in)
 	{
-		timer.step(deltaTime);
+		in.readVector(clips);
+		in.readVector(times);
+		in.readVector(lengths);
+		in.readVector(framesPerSecond);
+		in.readVector(frameCounts);
+		in.readVector(freeSlots);
 	}
-}; 
\ No newline at end of file
+
+	int clip(int instance) const { return clips[instance]; }
+	size_t size() const { return clips.size(); }
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+enum class LoadStatus
+{
+	loading, done, failed
+};
+
+// decodes image files into surfaces on worker threads. Workers claim the next path with
+// one atomic add, so a slow file never holds up the others; the render thread collects
+// the finished surfaces whenever it likes and does every texture upload itself
+class AssetLoader {
+	struct Decoded
+	{
+		size_t index;
+		SDL_Surface* surface; // nullptr when the file could not be read
+	};
+
+	std::vector<std::string> paths;
+	std::vector<std::thread> workers;
+	std::atomic<size_t> next;
+	std::mutex lock;
+	std::vector<Decoded> finished; // guarded by lock
+	size_t collected;
+
+	void workerLoop()
+	{
+		for (size_t i = next.fetch_add(1); i < paths.size(); i = next.fetch_add(1))
+		{
+			SDL_Surface* surface = IMG_Load(paths[i].c_str());
+			if (!surface)
+			{
+				SDL_Log("Failed to load %s: %s", paths[i].c_str(), SDL_GetError());
+			}
+			std::lock_guard<std::mutex> guard(lock);
+			finished.push_back(Decoded{ i, surface });
+		}
+	}
+
+public:
+	AssetLoader() : next(0), collected(0) {}
+	~AssetLoader() { stop(); }
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	// at least one worker, never more than there are files
+	void start(std::vector<std::string> files, size_t workerCount)
+	{
+		stop();
+		paths = std::move(files);
+		next = 0;
+		collected = 0;
+		finished.clear();
+		const size_t count = std::clamp<size_t>(workerCount, 1, std::max<size_t>(paths.size(), 1));
+		for (size_t i = 0; i < count; i++)
+		{
+			workers.emplace_back(&AssetLoader::workerLoop, this);
+		}
+	}
+
+	// move every surface decoded since the last call into surfaces[index], which must
+	// have one slot per file; returns true once all of them have been collected
+	bool collect(std::vector<SDL_Surface*>& surfaces)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		for (const Decoded& decoded : finished)
+		{
+			surfaces[decoded.index] = decoded.surface;
+		}
+		collected += finished.size();
+		finished.clear();
+		return collected == paths.size();
+	}
+
+	// waits for the workers, surfaces nobody collected are freed
+	void stop()
+	{
+		next = paths.size();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		workers.clear();
+		for (const Decoded& decoded : finished)
+		{
+			SDL_DestroySurface(decoded.surface);
+		}
+		finished.clear();
+	}
+
+	size_t getCollected() const { return collected; }
+	size_t size() const { return paths.size(); }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// every image the game uses, shared by the cooker and the loose-file loader;
+// paths are relative to the data directory
+struct AssetInfo
+{
+	const char* name;
+	const char* path;
+	int frameCount;
+};
+
+const AssetInfo ASSET_LIST[] = {
+	{ "idle", "idle.png", 4 },
+	{ "run", "run.png", 4 },
+	{ "slide", "slide.png", 1 },
+	{ "grass", "Tiles/grass1.png", 1 },
+	{ "deepGrass", "Tiles/deepGrass.png", 1 },
+	{ "grassR", "Tiles/grassR.png", 1 },
+	{ "grassL", "Tiles/grassL.png", 1 },
+	{ "grassConR", "Tiles/grassConR.png", 1 },
+	{ "grassConL", "Tiles/grassConL.png", 1 },
+	{ "bg1", "Background/j1.png", 1 },
+	{ "bg2", "Background/j2.png", 1 },
+	{ "bg3", "Background/j3.png", 1 },
+	{ "bg4", "Background/j4.png", 1 },
+	{ "bg5", "Background/j5.png", 1 },
+	{ "bg6", "Background/j6.png", 1 },
+	{ "bullet", "bullet.png", 1 },
+};
+const size_t ASSET_COUNT = sizeof(ASSET_LIST) / sizeof(ASSET_LIST[0]);
+
+const char* const DATA_DIR = "data/";
+const char* const ASSET_BUNDLE_PATH = "data/assets.bundle";
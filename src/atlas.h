@@ -0,0 +1,103 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <vector>
+#include <algorithm>
+
+// a region of a (usually shared) texture
+struct Sprite
+{
+	SDL_Texture* texture;
+	SDL_FRect rect;
+	int frameCount; // animation frames laid out left to right
+
+	Sprite() : texture(nullptr), rect{ 0 }, frameCount(1) {}
+};
+
+// packs images into one sheet using shelf packing; sprites handed to add()
+// get their rect filled in by pack() and their texture by build()
+class TextureAtlas {
+	struct Entry
+	{
+		SDL_Surface* image;
+		Sprite* sprite;
+		bool packed;
+	};
+
+	std::vector<Entry> entries;
+	SDL_Texture* texture;
+	int width;
+
+public:
+	static const int PADDING = 1;
+
+	TextureAtlas(int width) : texture(nullptr), width(width) {}
+
+	// takes ownership of image, a null image leaves the sprite empty
+	void add(SDL_Surface* image, Sprite& sprite)
+	{
+		entries.push_back(Entry{ image, &sprite, false });
+	}
+
+	// lay out and blit every image into one RGBA32 sheet owned by the caller
+	SDL_Surface* pack()
+	{
+		// tallest first keeps the shelves tight
+		std::vector<Entry*> order;
+		for (Entry& entry : entries)
+		{
+			if (entry.image)
+			{
+				order.push_back(&entry);
+			}
+		}
+		std::stable_sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) { return a->image->h > b->image->h; });
+
+		int penX = 0, penY = 0, shelfH = 0;
+		for (Entry* entry : order)
+		{
+			const int w = entry->image->w, h = entry->image->h;
+			if (penX + w > width)
+			{
+				penX = 0;
+				penY += shelfH + PADDING;
+				shelfH = 0;
+			}
+			entry->sprite->rect = SDL_FRect{ static_cast<float>(penX), static_cast<float>(penY), static_cast<float>(w), static_cast<float>(h) };
+			penX += w + PADDING;
+			shelfH = std::max(shelfH, h);
+		}
+		const int height = std::max(penY + shelfH, 1);
+
+		SDL_Surface* sheet = SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32);
+		for (Entry* entry : order)
+		{
+			SDL_Rect dst{
+				static_cast<int>(entry->sprite->rect.x), static_cast<int>(entry->sprite->rect.y),
+				entry->image->w, entry->image->h
+			};
+			SDL_SetSurfaceBlendMode(entry->image, SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(entry->image, nullptr, sheet, &dst);
+			SDL_DestroySurface(entry->image);
+			entry->image = nullptr;
+			entry->packed = true;
+		}
+		return sheet;
+	}
+
+	SDL_Texture* build(SDL_Renderer* renderer)
+	{
+		SDL_Surface* sheet = pack();
+		texture = SDL_CreateTextureFromSurface(renderer, sheet);
+		SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+		SDL_DestroySurface(sheet);
+
+		for (Entry& entry : entries)
+		{
+			entry.sprite->texture = entry.packed ? texture : nullptr;
+		}
+		entries.clear();
+		return texture;
+	}
+
+	SDL_Texture* getTexture() const { return texture; }
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include "alloctrack.h"
+
+enum class FramePhase
+{
+	events, update, animate, parallax, objects, tiles, present, count
+};
+
+const char* const FRAME_PHASE_NAMES[] = { "events", "update", "animate", "parallax", "objects", "tiles", "present" };
+const size_t FRAME_PHASE_COUNT = static_cast<size_t>(FramePhase::count);
+static_assert(FRAME_PHASE_COUNT <= ALLOC_MAX_PHASES, "AllocTracker needs a slot per phase");
+
+// splits the wall-clock time of one frame into phases, heap allocations are split the same way
+class FrameTimer {
+	std::array<uint64_t, FRAME_PHASE_COUNT> phaseTicks;
+	uint64_t frameStart, last;
+
+public:
+	FrameTimer() : frameStart(0), last(0) { phaseTicks.fill(0); }
+
+	void begin()
+	{
+		frameStart = last = SDL_GetPerformanceCounter();
+		phaseTicks.fill(0);
+		AllocTracker::instance().beginFrame();
+	}
+
+	// charge the time since the previous mark to phase
+	void mark(FramePhase phase)
+	{
+		uint64_t now = SDL_GetPerformanceCounter();
+		phaseTicks[static_cast<size_t>(phase)] += now - last;
+		last = now;
+		AllocTracker::instance().mark(static_cast<size_t>(phase));
+	}
+
+	double totalMs() const { return toMs(last - frameStart); }
+	double phaseMs(size_t phase) const { return toMs(phaseTicks[phase]); }
+
+	static double toMs(uint64_t ticks) { return ticks * 1000.0 / SDL_GetPerformanceFrequency(); }
+};
+
+// frame samples of a headless benchmark run, reported as JSON
+class BenchStats {
+	std::vector<double> frameMs;
+	std::array<std::vector<double>, FRAME_PHASE_COUNT> phaseMs;
+	std::vector<std::pair<const char*, std::vector<double>>> counters;
+
+	static void printSummary(FILE* out, std::vector<double>& samples)
+	{
+		if (samples.empty())
+		{
+			std::fprintf(out, "{}");
+			return;
+		}
+		std::sort(samples.begin(), samples.end());
+		double sum = 0;
+		for (double s : samples)
+		{
+			sum += s;
+		}
+		const auto percentile = [&samples](double p) { return samples[static_cast<size_t>(p * (samples.size() - 1))]; };
+		std::fprintf(out, "{\"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+			samples.front(), sum / samples.size(), percentile(0.5), percentile(0.99), samples.back());
+	}
+
+public:
+	void reserve(size_t frames)
+	{
+		frameMs.reserve(frames);
+		for (auto& phase : phaseMs)
+		{
+			phase.reserve(frames);
+		}
+	}
+
+	void record(const FrameTimer& timer)
+	{
+		frameMs.push_back(timer.totalMs());
+		for (size_t i = 0; i < FRAME_PHASE_COUNT; i++)
+		{
+			phaseMs[i].push_back(timer.phaseMs(i));
+		}
+	}
+
+	// per-frame value of a named counter, name must outlive the stats
+	void recordCounter(const char* name, double value)
+	{
+		for (auto& counter : counters)
+		{
+			if (std::strcmp(counter.first, name) == 0)
+			{
+				counter.second.push_back(value);
+				return;
+			}
+		}
+		counters.emplace_back(name, std::vector<double>{ value });
+		counters.back().second.reserve(frameMs.capacity());
+	}
+
+	// the caller opens the top-level object and may append its own fields first
+	void printJson(FILE* out)
+	{
+		std::fprintf(out, "\"frames\": %zu,\n  \"frame_ms\": ", frameMs.size());
+		printSummary(out, frameMs);
+		std::fprintf(out, ",\n  \"phases_ms\": {");
+		for (size_t i = 0; i < FRAME_PHASE_COUNT; i++)
+		{
+			std::fprintf(out, "%s\n    \"%s\": ", i ? "," : "", FRAME_PHASE_NAMES[i]);
+			printSummary(out, phaseMs[i]);
+		}
+		std::fprintf(out, "\n  },\n  \"counters\": {");
+		for (size_t i = 0; i < counters.size(); i++)
+		{
+			std::fprintf(out, "%s\n    \"%s\": ", i ? "," : "", counters[i].first);
+			printSummary(out, counters[i].second);
+		}
+		std::fprintf(out, "\n  }");
+	}
+};
+
+// deterministic keyboard script for headless runs: run right, run left,
+// then stand and shoot, jumping regularly throughout
+class ScriptedInput {
+	std::array<bool, SDL_SCANCODE_COUNT> keys;
+
+	void set(SDL_Scancode key, bool down)
+	{
+		if (keys[key] == down)
+		{
+			return;
+		}
+		keys[key] = down;
+		SDL_Event event{ 0 };
+		event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+		event.key.scancode = key;
+		event.key.down = down;
+		SDL_PushEvent(&event);
+	}
+
+public:
+	ScriptedInput() { keys.fill(false); }
+
+	const bool* data() const { return keys.data(); }
+
+	// update held keys for this frame and queue events for every change
+	void apply(int frame)
+	{
+		const int t = frame % 240;
+		set(SDL_SCANCODE_D, t < 120);
+		set(SDL_SCANCODE_A, t >= 120 && t < 180);
+		set(SDL_SCANCODE_F, t >= 180);
+		set(SDL_SCANCODE_SPACE, frame % 60 >= 30 && frame % 60 < 35);
+	}
+};
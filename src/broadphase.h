@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <SDL3/SDL.h>
+
+// sweep-and-prune on x: boxes are sorted by their left edge, then each box is only
+// tested against the boxes that start before it ends. On a side-scroller most things
+// are spread along x, so the tests stay close to linear in the number of boxes
+class SweepAndPrune {
+public:
+	struct Pair
+	{
+		uint8_t groupA, groupB; // groupA <= groupB
+		uint32_t idA, idB;
+	};
+
+private:
+	struct Proxy
+	{
+		float minX, maxX, minY, maxY;
+		uint8_t group;
+		uint32_t id;
+	};
+
+	std::vector<Proxy> proxies;
+	std::vector<uint32_t> masks; // per group, bit g set when it should pair with group g
+	size_t tests;
+
+public:
+	SweepAndPrune() : tests(0) {}
+
+	// pairs between group a and group b will be reported
+	void enable(uint8_t a, uint8_t b)
+	{
+		masks.resize(std::max<size_t>(masks.size(), std::max(a, b) + 1), 0);
+		masks[a] |= 1u << b;
+		masks[b] |= 1u << a;
+	}
+
+	void reserve(size_t count) { proxies.reserve(count); }
+	void clear() { proxies.clear(); }
+
+	void add(const SDL_FRect& rect, uint8_t group, uint32_t id)
+	{
+		proxies.push_back(Proxy{ rect.x, rect.x + rect.w, rect.y, rect.y + rect.h, group, id });
+	}
+
+	// onPair(pair) for every overlapping pair of enabled groups, in sweep order; equal edges
+	// are ordered by group and id so the order only depends on the boxes
+	template <typename OnPair>
+	void findPairs(OnPair&& onPair)
+	{
+		std::sort(proxies.begin(), proxies.end(), [](const Proxy& a, const Proxy& b) {
+			if (a.minX != b.minX)
+			{
+				return a.minX < b.minX;
+			}
+			return a.group != b.group ? a.group < b.group : a.id < b.id;
+		});
+		tests = 0;
+		const size_t count = proxies.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			const Proxy& a = proxies[i];
+			const uint32_t mask = a.group < masks.size() ? masks[a.group] : 0;
+			if (!mask)
+			{
+				continue;
+			}
+			for (size_t j = i + 1; j < count && proxies[j].minX < a.maxX; j++)
+			{
+				const Proxy& b = proxies[j];
+				tests++;
+				if ((mask >> b.group & 1u) && a.minY < b.maxY && b.minY < a.maxY)
+				{
+					onPair(a.group <= b.group ? Pair{ a.group, b.group, a.id, b.id } : Pair{ b.group, a.group, b.id, a.id });
+				}
+			}
+		}
+	}
+
+	size_t size() const { return proxies.size(); }
+	size_t getTests() const { return tests; }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "gameobject.h"
+#include "animation.h"
+#include "snapshot.h"
+
+// fixed capacity bullet storage, live bullets are packed at the front
+class BulletPool {
+	std::vector<GameObject> items;
+	size_t count;
+
+public:
+	BulletPool() : count(0) {}
+
+	// allocate every slot and its animation instance up front so spawning never touches the heap
+	void init(size_t capacity, Animator& animator, const std::vector<AnimationClip>& clips, int clip)
+	{
+		items.assign(capacity, GameObject());
+		for (GameObject& bullet : items)
+		{
+			bullet.type = ObjectType::bullet;
+			bullet.animation = animator.create(clips, clip);
+		}
+		count = 0;
+	}
+
+	// hands out a recycled slot with fresh bullet data playing clip from the start,
+	// nullptr when the pool is full
+	GameObject* spawn(Animator& animator, const std::vector<AnimationClip>& clips, int clip)
+	{
+		if (count == items.size())
+		{
+			return nullptr;
+		}
+		GameObject& bullet = items[count++];
+		bullet.data.bullet = BulletData();
+		animator.restart(bullet.animation, clips, clip);
+		return &bullet;
+	}
+
+	// swap-and-pop every bullet that was marked inactive this frame
+	void retireInactive()
+	{
+		size_t i = 0;
+		while (i < count)
+		{
+			if (items[i].data.bullet.state == BulletState::inactive)
+			{
+				std::swap(items[i], items[count - 1]);
+				count--;
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	// every slot, live or not, so each keeps the animation instance it was given
+	void save(SnapshotWriter& out) const
+	{
+		out.write(static_cast<uint32_t>(count));
+		out.writeVector(items);
+	}
+
+	void load(SnapshotReader& in)
+	{
+		count = in.read<uint32_t>();
+		in.readVector(items);
+	}
+
+	GameObject* begin() { return items.data(); }
+	GameObject* end() { return items.data() + count; }
+	const GameObject* begin() const { return items.data(); }
+	const GameObject* end() const { return items.data() + count; }
+	size_t size() const { return count; }
+	size_t capacity() const { return items.size(); }
+};
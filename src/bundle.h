@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "mappedfile.h"
+
+/*
+Cooked asset bundle layout, little endian:
+	BundleHeader
+	BundleEntry[entryCount]
+	atlas pixels, RGBA32, height rows of pitch bytes, starting at pixelOffset
+*/
+const char BUNDLE_MAGIC[4] = { 'R', 'P', 'G', 'B' };
+const uint32_t BUNDLE_VERSION = 1;
+const size_t BUNDLE_NAME_SIZE = 32;
+
+struct BundleHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t width, height, pitch;
+	uint64_t pixelOffset;
+};
+
+struct BundleEntry
+{
+	char name[BUNDLE_NAME_SIZE];
+	float x, y, w, h;
+	int32_t frameCount;
+	int32_t reserved;
+};
+
+static_assert(sizeof(BundleHeader) == 32, "bundle header layout changed");
+static_assert(sizeof(BundleEntry) == 56, "bundle entry layout changed");
+
+// read side of the bundle, everything points straight into the mapping
+class AssetBundle {
+	MappedFile file;
+	const BundleHeader* header;
+	const BundleEntry* entries;
+
+public:
+	AssetBundle() : header(nullptr), entries(nullptr) {}
+
+	// maps the file and checks it is a complete bundle of the current version
+	bool open(const char* path)
+	{
+		header = nullptr;
+		entries = nullptr;
+		if (!file.open(path) || file.size() < sizeof(BundleHeader))
+		{
+			return false;
+		}
+		const BundleHeader* h = reinterpret_cast<const BundleHeader*>(file.data());
+		const uint64_t entriesEnd = sizeof(BundleHeader) + static_cast<uint64_t>(h->entryCount) * sizeof(BundleEntry);
+		if (std::memcmp(h->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 || h->version != BUNDLE_VERSION ||
+			entriesEnd > h->pixelOffset || h->pixelOffset + static_cast<uint64_t>(h->pitch) * h->height > file.size())
+		{
+			file.close();
+			return false;
+		}
+		header = h;
+		entries = reinterpret_cast<const BundleEntry*>(file.data() + sizeof(BundleHeader));
+		return true;
+	}
+
+	void close()
+	{
+		file.close();
+		header = nullptr;
+		entries = nullptr;
+	}
+
+	const BundleEntry* find(const char* name) const
+	{
+		for (uint32_t i = 0; header && i < header->entryCount; i++)
+		{
+			if (std::strncmp(entries[i].name, name, BUNDLE_NAME_SIZE) == 0)
+			{
+				return &entries[i];
+			}
+		}
+		return nullptr;
+	}
+
+	int width() const { return static_cast<int>(header->width); }
+	int height() const { return static_cast<int>(header->height); }
+	int pitch() const { return static_cast<int>(header->pitch); }
+	const void* pixels() const { return file.data() + header->pixelOffset; }
+};
@@ -0,0 +1,218 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "tilemap.h"
+#include "culling.h"
+#include "spritebatch.h"
+#include "renderqueue.h"
+
+// one tile map layer baked into render target textures, one per run of chunkCols
+// columns starting at firstChunk; textures are baked on first sight and dropped once
+// the camera is far away. Only draw() and release() call into the renderer, so build() can
+// run while the main thread executes a frame that still uses the textures it drops
+class ChunkCache {
+	struct Chunk
+	{
+		SDL_Texture* texture;
+		bool dirty;
+		int tiles;
+	};
+
+	std::vector<Chunk> chunks;
+	std::vector<int> resident;
+	std::vector<SDL_Texture*> retired; // dropped by build(), destroyed on the next draw
+	SpriteBatch batch;
+	int occupied; // chunks holding at least one tile
+	int firstChunk;
+	int layer, chunkCols, tileSize, keepRadius;
+	float originY, chunkW, chunkH;
+
+	void bake(SDL_Renderer* renderer, const TileMap& map, int index)
+	{
+		Chunk& chunk = chunks[index];
+		if (!chunk.texture)
+		{
+			chunk.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+				static_cast<int>(chunkW), static_cast<int>(chunkH));
+			SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+			SDL_SetTextureScaleMode(chunk.texture, SDL_SCALEMODE_NEAREST);
+			resident.push_back(index);
+		}
+
+		Uint8 r, g, b, a;
+		SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+		SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer);
+		SDL_SetRenderTarget(renderer, chunk.texture);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+		SDL_RenderClear(renderer);
+
+		const SDL_FRect src{ 0, 0, static_cast<float>(tileSize), static_cast<float>(tileSize) };
+		const int firstCol = (firstChunk + index) * chunkCols - map.getOriginCol();
+		const int lastCol = std::min(firstCol + chunkCols, map.getCols());
+		for (int r = 0; r < map.getRows(); r++)
+		{
+			for (int c = firstCol; c < lastCol; c++)
+			{
+				const Sprite* sprite = map.info(map.at(layer, r, c)).sprite;
+				if (sprite && sprite->texture)
+				{
+					const SDL_FRect dst{
+						.x = static_cast<float>((c - firstCol) * tileSize),
+						.y = static_cast<float>(r * tileSize),
+						.w = static_cast<float>(tileSize),
+						.h = static_cast<float>(tileSize)
+					};
+					batch.add(renderer, *sprite, src, dst, false);
+				}
+			}
+		}
+		batch.flush(renderer);
+
+		SDL_SetRenderTarget(renderer, prevTarget);
+		SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		chunk.dirty = false;
+	}
+
+	void destroyRetired()
+	{
+		for (SDL_Texture* texture : retired)
+		{
+			SDL_DestroyTexture(texture);
+		}
+		retired.clear();
+	}
+
+public:
+	ChunkCache() : occupied(0), firstChunk(0), layer(0), chunkCols(1), tileSize(1), keepRadius(1), originY(0), chunkW(0), chunkH(0) {}
+
+	// split a layer of the map's columns into chunks; the map must start on a chunk
+	// boundary. Textures of chunks still in range are kept, nothing new is baked until
+	// it becomes visible
+	void build(const TileMap& map, int layer, int chunkCols)
+	{
+		this->layer = layer;
+		this->chunkCols = chunkCols;
+		tileSize = map.getTileSize();
+		originY = map.getOriginY();
+		chunkW = static_cast<float>(chunkCols * tileSize);
+		chunkH = static_cast<float>(map.getRows() * tileSize);
+		const int cols = map.getCols();
+
+		std::vector<Chunk> previous;
+		previous.swap(chunks);
+		const int previousFirst = firstChunk;
+		firstChunk = map.getOriginCol() / chunkCols;
+		chunks.assign((cols + chunkCols - 1) / chunkCols, Chunk{ nullptr, true, 0 });
+
+		// room for every chunk, so bake() never grows it mid-frame
+		std::vector<int> kept;
+		kept.reserve(chunks.size());
+		for (int index : resident)
+		{
+			const int local = previousFirst + index - firstChunk;
+			if (local >= 0 && local < static_cast<int>(chunks.size()))
+			{
+				chunks[local].texture = previous[index].texture;
+				chunks[local].dirty = previous[index].dirty;
+				kept.push_back(local);
+			}
+			else
+			{
+				retired.push_back(previous[index].texture);
+			}
+		}
+		resident.swap(kept);
+
+		for (int r = 0; r < map.getRows(); r++)
+		{
+			for (int c = 0; c < cols; c++)
+			{
+				chunks[c / chunkCols].tiles += map.at(layer, r, c) != TILE_EMPTY ? 1 : 0;
+			}
+		}
+		occupied = 0;
+		for (const Chunk& chunk : chunks)
+		{
+			occupied += chunk.tiles ? 1 : 0;
+		}
+	}
+
+	// a tile in the column at world x changed, rebake its chunk when next drawn
+	void markDirty(float x)
+	{
+		const int index = static_cast<int>(std::floor(x / chunkW)) - firstChunk;
+		if (index >= 0 && index < static_cast<int>(chunks.size()))
+		{
+			chunks[index].dirty = true;
+		}
+	}
+
+	// queue the chunks that pass the culler on target, only the column range under its bounds
+	// is visited. Dirty chunks are baked right away
+	void draw(SDL_Renderer* renderer, const TileMap& map, const SDL_FRect& viewport, ViewCuller& culler, RenderQueue& queue, RenderLayer target)
+	{
+		destroyRetired();
+		const SDL_FRect& bounds = culler.getBounds();
+		const int count = static_cast<int>(chunks.size());
+		const int first = std::max(static_cast<int>(std::floor(bounds.x / chunkW)) - firstChunk, 0);
+		const int last = std::min(static_cast<int>(std::floor((bounds.x + bounds.w) / chunkW)) - firstChunk, count - 1);
+
+		int tested = 0;
+		for (int i = first; i <= last; i++)
+		{
+			Chunk& chunk = chunks[i];
+			if (!chunk.tiles)
+			{
+				continue;
+			}
+			tested++;
+			SDL_FRect rect{ (firstChunk + i) * chunkW, originY, chunkW, chunkH };
+			if (!culler.visible(rect))
+			{
+				continue;
+			}
+			if (chunk.dirty || !chunk.texture)
+			{
+				bake(renderer, map, i);
+			}
+			SDL_FRect dst{
+				.x = rect.x - viewport.x,
+				.y = rect.y - viewport.y,
+				.w = chunkW,
+				.h = chunkH
+			};
+			queue.add(target, chunk.texture, SDL_FRect{ 0, 0, chunkW, chunkH }, dst, false);
+		}
+		culler.addCulled(occupied - tested);
+
+		// keep memory bounded on long levels
+		for (size_t r = 0; r < resident.size();)
+		{
+			const int index = resident[r];
+			if (index < first - keepRadius || index > last + keepRadius)
+			{
+				SDL_DestroyTexture(chunks[index].texture);
+				chunks[index].texture = nullptr;
+				resident[r] = resident.back();
+				resident.pop_back();
+			}
+			else
+			{
+				r++;
+			}
+		}
+	}
+
+	void release()
+	{
+		destroyRetired();
+		for (int index : resident)
+		{
+			SDL_DestroyTexture(chunks[index].texture);
+			chunks[index].texture = nullptr;
+		}
+		resident.clear();
+	}
+};
@@ -0,0 +1,151 @@
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <cstdlib>
+
+#include "atlas.h"
+#include "assets.h"
+#include "bundle.h"
+#include "levelfile.h"
+#include "maps.h"
+
+// offline asset cooker: decodes every image in ASSET_LIST once, packs them
+// into one atlas and writes the pixels and manifest as a single bundle
+// usage: cooker <data dir> <output bundle>
+//        cooker --level <output level> [cols]
+// the level mode writes the built-in map, repeated to cols columns for stress runs
+
+const int ATLAS_WIDTH = 2048;
+const short PLAYER_TILE = 7;
+
+int cookLevel(const char* path, int cols)
+{
+	// the player marker moves into the header, the first one wins
+	int spawnRow = 0, spawnCol = 0;
+	bool found = false;
+	for (int r = 0; r < MAP_ROWS && !found; r++)
+	{
+		for (int c = 0; c < MAP_COLS && !found; c++)
+		{
+			if (DEFAULT_MAP[r][c] == PLAYER_TILE)
+			{
+				spawnRow = r;
+				spawnCol = c;
+				found = true;
+			}
+		}
+	}
+
+	const short (*layers[LEVEL_LAYERS])[MAP_COLS] = { DEFAULT_MAP, DEFAULT_FOREGROUND, DEFAULT_BACKGROUND };
+	const bool ok = writeLevel(path, MAP_ROWS, cols, LEVEL_CHUNK_COLS, spawnRow, spawnCol,
+		[&layers](int layer, int r, int c)
+		{
+			const short tile = layers[layer][r][c % MAP_COLS];
+			return tile == PLAYER_TILE ? 0 : tile;
+		});
+	if (!ok)
+	{
+		std::fprintf(stderr, "cooker: cannot write %s\n", path);
+		return 1;
+	}
+	std::printf("cooker: %dx%d level, %d chunks -> %s\n", MAP_ROWS, cols, (cols + LEVEL_CHUNK_COLS - 1) / LEVEL_CHUNK_COLS, path);
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc >= 3 && std::strcmp(argv[1], "--level") == 0)
+	{
+		const int cols = argc >= 4 ? std::max(MAP_COLS, std::atoi(argv[3])) : MAP_COLS;
+		return cookLevel(argv[2], cols);
+	}
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "usage: %s <data dir> <output bundle>\n       %s --level <output level> [cols]\n", argv[0], argv[0]);
+		return 1;
+	}
+	std::string dataDir = argv[1];
+	if (!dataDir.empty() && dataDir.back() != '/' && dataDir.back() != '\\')
+	{
+		dataDir += '/';
+	}
+
+	// decode, a missing source image fails the cook
+	std::vector<Sprite> sprites(ASSET_COUNT);
+	TextureAtlas atlas(ATLAS_WIDTH);
+	for (size_t i = 0; i < ASSET_COUNT; i++)
+	{
+		const std::string path = dataDir + ASSET_LIST[i].path;
+		SDL_Surface* image = IMG_Load(path.c_str());
+		if (!image)
+		{
+			std::fprintf(stderr, "cooker: failed to load %s: %s\n", path.c_str(), SDL_GetError());
+			return 1;
+		}
+		if (std::strlen(ASSET_LIST[i].name) >= BUNDLE_NAME_SIZE)
+		{
+			std::fprintf(stderr, "cooker: asset name too long: %s\n", ASSET_LIST[i].name);
+			return 1;
+		}
+		atlas.add(image, sprites[i]);
+	}
+	SDL_Surface* sheet = atlas.pack();
+	if (!sheet)
+	{
+		std::fprintf(stderr, "cooker: failed to create atlas: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	// manifest
+	BundleHeader header{};
+	std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+	header.version = BUNDLE_VERSION;
+	header.entryCount = static_cast<uint32_t>(ASSET_COUNT);
+	header.width = static_cast<uint32_t>(sheet->w);
+	header.height = static_cast<uint32_t>(sheet->h);
+	header.pitch = static_cast<uint32_t>(sheet->w * 4);
+	header.pixelOffset = sizeof(BundleHeader) + ASSET_COUNT * sizeof(BundleEntry);
+
+	std::vector<BundleEntry> entries(ASSET_COUNT);
+	for (size_t i = 0; i < ASSET_COUNT; i++)
+	{
+		BundleEntry& entry = entries[i];
+		std::memset(&entry, 0, sizeof(entry));
+		std::strncpy(entry.name, ASSET_LIST[i].name, BUNDLE_NAME_SIZE - 1);
+		entry.x = sprites[i].rect.x;
+		entry.y = sprites[i].rect.y;
+		entry.w = sprites[i].rect.w;
+		entry.h = sprites[i].rect.h;
+		entry.frameCount = ASSET_LIST[i].frameCount;
+	}
+
+	std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		std::fprintf(stderr, "cooker: cannot write %s\n", argv[2]);
+		SDL_DestroySurface(sheet);
+		return 1;
+	}
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BundleEntry));
+	// rows are written tightly packed whatever the surface pitch is
+	const unsigned char* pixels = static_cast<const unsigned char*>(sheet->pixels);
+	for (int y = 0; y < sheet->h; y++)
+	{
+		out.write(reinterpret_cast<const char*>(pixels + static_cast<size_t>(y) * sheet->pitch), header.pitch);
+	}
+	SDL_DestroySurface(sheet);
+
+	if (!out)
+	{
+		std::fprintf(stderr, "cooker: write failed for %s\n", argv[2]);
+		return 1;
+	}
+	std::printf("cooker: %zu assets, %ux%u atlas -> %s\n", ASSET_COUNT, header.width, header.height, argv[2]);
+	return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <SDL3/SDL.h>
+
+// single visibility test for everything that is drawn: bounds that miss the
+// viewport grown by a margin are dropped, and both outcomes are counted per frame
+class ViewCuller {
+	SDL_FRect bounds;
+	int submitted, culled;
+
+public:
+	ViewCuller() : bounds{ 0 }, submitted(0), culled(0) {}
+
+	void begin(const SDL_FRect& viewport, float margin)
+	{
+		bounds = SDL_FRect{
+			.x = viewport.x - margin,
+			.y = viewport.y - margin,
+			.w = viewport.w + margin * 2,
+			.h = viewport.h + margin * 2
+		};
+		submitted = culled = 0;
+	}
+
+	// world space rect, true when it should be submitted to the renderer
+	bool visible(const SDL_FRect& rect)
+	{
+		if (SDL_HasRectIntersectionFloat(&rect, &bounds))
+		{
+			submitted++;
+			return true;
+		}
+		culled++;
+		return false;
+	}
+
+	// for callers that reject whole ranges without testing each item
+	void addCulled(int count) { culled += count; }
+
+	const SDL_FRect& getBounds() const { return bounds; }
+	int getSubmitted() const { return submitted; }
+	int getCulled() const { return culled; }
+};
@@ -0,0 +1,271 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include "tilemap.h"
+#include "levelfile.h"
+#include "snapshot.h"
+
+enum class EnemyState : uint8_t
+{
+	patrol, chase, attack
+};
+
+const float ENEMY_GRAVITY = 500.0f;
+const float ENEMY_PATROL_SPEED = 30.0f;
+const float ENEMY_CHASE_SPEED = 60.0f;
+const float ENEMY_PATROL_RANGE = 64.0f;   // distance from home before turning around
+const float ENEMY_CHASE_RANGE = 160.0f;
+const float ENEMY_CHASE_HEIGHT = 48.0f;
+const float ENEMY_ATTACK_RANGE = 20.0f;
+const float ENEMY_ATTACK_COOLDOWN = 0.6f;
+const int ENEMY_HEALTH = 3;                // bullet hits
+const float ENEMY_HIT_HOP = -80.0f;
+
+// every enemy as parallel arrays, updated a range at a time in passes that each
+// touch only the arrays they need; ranges are independent so they can run on job threads
+class EnemySystem {
+	std::vector<float> posX, posY, prevX, prevY, velX, velY, dir, homeX, cooldown;
+	std::vector<EnemyState> states;
+	std::vector<int> anims, health;
+	SDL_FRect collider; // shared, relative to the position
+
+public:
+	EnemySystem() : collider{ 6, 6, 20, 26 } {}
+
+	void reserve(size_t count)
+	{
+		for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &dir, &homeX, &cooldown })
+		{
+			array->reserve(count);
+		}
+		states.reserve(count);
+		anims.reserve(count);
+		health.reserve(count);
+	}
+
+	void spawn(float x, float y, float direction, int anim)
+	{
+		posX.push_back(x);
+		posY.push_back(y);
+		prevX.push_back(x);
+		prevY.push_back(y);
+		velX.push_back(0);
+		velY.push_back(0);
+		dir.push_back(direction);
+		homeX.push_back(x);
+		cooldown.push_back(0);
+		states.push_back(EnemyState::patrol);
+		anims.push_back(anim);
+		health.push_back(ENEMY_HEALTH);
+	}
+
+	// a bullet landed: hop, turn on the shooter and lose health, retireDead removes it at 0
+	void hit(size_t i, float fromDirection)
+	{
+		velY[i] = ENEMY_HIT_HOP;
+		dir[i] = -fromDirection;
+		states[i] = EnemyState::chase;
+		health[i]--;
+	}
+
+	// swap-and-pop every enemy out of health, onRetire(anim) releases its animation
+	template <typename OnRetire>
+	void retireDead(OnRetire&& onRetire)
+	{
+		size_t i = 0;
+		while (i < health.size())
+		{
+			if (health[i] > 0)
+			{
+				i++;
+				continue;
+			}
+			onRetire(anims[i]);
+			const size_t last = health.size() - 1;
+			for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &dir, &homeX, &cooldown })
+			{
+				(*array)[i] = array->back();
+				array->pop_back();
+			}
+			states[i] = states[last];
+			states.pop_back();
+			anims[i] = anims[last];
+			anims.pop_back();
+			health[i] = health[last];
+			health.pop_back();
+		}
+	}
+
+	// one tick for enemies [begin, end); target is the player's collider center and
+	// attack(i, direction) is called when enemy i lands a hit
+	template <typename Attack>
+	void update(size_t begin, size_t end, const TileMap& tiles, glm::vec2 target, float floorY, float deltaTime, Attack&& attack)
+	{
+		const float centerX = collider.x + collider.w / 2, centerY = collider.y + collider.h / 2;
+
+		// decide
+		for (size_t i = begin; i < end; i++)
+		{
+			const float dx = target.x - (posX[i] + centerX);
+			const float adx = std::abs(dx), ady = std::abs(target.y - (posY[i] + centerY));
+			const float toward = dx < 0 ? -1.0f : 1.0f;
+			switch (states[i])
+			{
+				case EnemyState::patrol:
+				{
+					if (adx < ENEMY_CHASE_RANGE && ady < ENEMY_CHASE_HEIGHT)
+					{
+						states[i] = EnemyState::chase;
+					}
+					else if ((posX[i] - homeX[i]) * dir[i] > ENEMY_PATROL_RANGE)
+					{
+						dir[i] = -dir[i];
+					}
+					break;
+				}
+				case EnemyState::chase:
+				{
+					if (adx < ENEMY_ATTACK_RANGE && ady < ENEMY_CHASE_HEIGHT)
+					{
+						states[i] = EnemyState::attack;
+						cooldown[i] = ENEMY_ATTACK_COOLDOWN;
+					}
+					else if (adx > ENEMY_CHASE_RANGE * 1.25f || ady > ENEMY_CHASE_HEIGHT * 1.25f)
+					{
+						// give up and patrol around wherever the chase ended
+						states[i] = EnemyState::patrol;
+						homeX[i] = posX[i];
+					}
+					break;
+				}
+				case EnemyState::attack:
+				{
+					if (adx > ENEMY_ATTACK_RANGE * 1.5f || ady > ENEMY_CHASE_HEIGHT)
+					{
+						states[i] = EnemyState::chase;
+					}
+					break;
+				}
+			}
+			switch (states[i])
+			{
+				case EnemyState::patrol:
+				{
+					velX[i] = dir[i] * ENEMY_PATROL_SPEED;
+					break;
+				}
+				case EnemyState::chase:
+				{
+					dir[i] = toward;
+					velX[i] = toward * ENEMY_CHASE_SPEED;
+					break;
+				}
+				case EnemyState::attack:
+				{
+					dir[i] = toward;
+					velX[i] = 0;
+					cooldown[i] -= deltaTime;
+					if (cooldown[i] <= 0)
+					{
+						cooldown[i] += ENEMY_ATTACK_COOLDOWN;
+						attack(i, toward);
+					}
+					break;
+				}
+			}
+		}
+
+		// integrate, straight-line float math over contiguous arrays
+		float* px = posX.data();
+		float* py = posY.data();
+		float* vy = velY.data();
+		const float* vx = velX.data();
+		std::copy(posX.begin() + begin, posX.begin() + end, prevX.begin() + begin);
+		std::copy(posY.begin() + begin, posY.begin() + end, prevY.begin() + begin);
+		for (size_t i = begin; i < end; i++)
+		{
+			vy[i] += ENEMY_GRAVITY * deltaTime;
+			px[i] += vx[i] * deltaTime;
+			py[i] += vy[i] * deltaTime;
+		}
+
+		// resolve against the level the same way the player does, walls turn patrols around
+		for (size_t i = begin; i < end; i++)
+		{
+			const float walkedX = posX[i];
+			const SDL_FRect bounds{ posX[i] + collider.x, posY[i] + collider.y, collider.w, collider.h };
+			tiles.query(LEVEL_LAYER_SOLID, bounds, 1, [&](const SDL_FRect& tile) {
+				const SDL_FRect rect{ posX[i] + collider.x, posY[i] + collider.y, collider.w, collider.h };
+				SDL_FRect overlap;
+				if (!SDL_GetRectIntersectionFloat(&rect, &tile, &overlap))
+				{
+					return;
+				}
+				if (overlap.w < overlap.h)
+				{
+					posX[i] += rect.x < tile.x ? -overlap.w : overlap.w;
+				}
+				else
+				{
+					if (velY[i] > 0)
+					{
+						posY[i] -= overlap.h;
+					}
+					else if (velY[i] < 0)
+					{
+						posY[i] += overlap.h;
+					}
+					velY[i] = 0;
+				}
+			});
+			if (posX[i] != walkedX && states[i] == EnemyState::patrol)
+			{
+				dir[i] = -dir[i];
+			}
+
+			// outside the resident level there is nothing to stand on but the bottom of the screen
+			if (posY[i] > floorY - collider.y - collider.h)
+			{
+				posY[i] = floorY - collider.y - collider.h;
+				velY[i] = 0;
+			}
+		}
+	}
+
+	void save(SnapshotWriter& out) const
+	{
+		for (const std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &dir, &homeX, &cooldown })
+		{
+			out.writeVector(*array);
+		}
+		out.writeVector(states);
+		out.writeVector(anims);
+		out.writeVector(health);
+	}
+
+	void load(SnapshotReader& in)
+	{
+		for (std::vector<float>* array : { &posX, &posY, &prevX, &prevY, &velX, &velY, &dir, &homeX, &cooldown })
+		{
+			in.readVector(*array);
+		}
+		in.readVector(states);
+		in.readVector(anims);
+		in.readVector(health);
+	}
+
+	size_t size() const { return posX.size(); }
+	glm::vec2 position(size_t i) const { return glm::vec2(posX[i], posY[i]); }
+	glm::vec2 prevPosition(size_t i) const { return glm::vec2(prevX[i], prevY[i]); }
+	glm::vec2 velocity(size_t i) const { return glm::vec2(velX[i], velY[i]); }
+	float direction(size_t i) const { return dir[i]; }
+	EnemyState state(size_t i) const { return states[i]; }
+	int anim(size_t i) const { return anims[i]; }
+	bool alive(size_t i) const { return health[i] > 0; }
+	SDL_FRect bounds(size_t i) const { return SDL_FRect{ posX[i] + collider.x, posY[i] + collider.y, collider.w, collider.h }; }
+	const SDL_FRect& getCollider() const { return collider; }
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// fixed timestep accumulator fed with nanosecond clock readings
+class FixedStep {
+	uint64_t tickNS, accumulator, lastTime;
+	int maxSteps;
+
+public:
+	FixedStep(int tickRate, int maxSteps) : tickNS(1000000000ull / tickRate), accumulator(0), lastTime(0), maxSteps(maxSteps)
+	{
+
+	}
+
+	void start(uint64_t now) { lastTime = now; accumulator = 0; }
+
+	// number of ticks to simulate for the time elapsed since the last call;
+	// backlog beyond maxSteps is dropped so a hitch can't snowball
+	int advance(uint64_t now)
+	{
+		accumulator += now - lastTime;
+		lastTime = now;
+
+		uint64_t steps = accumulator / tickNS;
+		accumulator -= steps * tickNS;
+		if (steps > static_cast<uint64_t>(maxSteps))
+		{
+			steps = maxSteps;
+		}
+		return static_cast<int>(steps);
+	}
+
+	// how far the render frame sits between the previous and the current tick
+	float alpha() const { return static_cast<float>(accumulator) / tickNS; }
+	float tickSeconds() const { return tickNS / 1e9f; }
+	uint64_t getTickNS() const { return tickNS; }
+};
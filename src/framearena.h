@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <thread>
+#include <new>
+#include <algorithm>
+#include <type_traits>
+
+// bump allocator for data that lives for a frame. Two buffers take turns: beginFrame()
+// empties the older one and makes it current, so anything allocated last frame stays valid
+// through this one and no longer. Allocation is one atomic add, so job threads can use it;
+// nothing is freed individually. A frame that outgrows its buffer falls back to the heap
+// and the overflow is freed when the buffer comes round again
+class FrameArena {
+	struct Block
+	{
+		void* memory;
+		size_t alignment; // over-aligned blocks need the matching delete
+	};
+
+	struct Buffer
+	{
+		std::unique_ptr<std::byte[]> memory;
+		std::atomic<size_t> used;
+		std::vector<Block> overflow; // heap blocks handed out once memory ran out
+	};
+
+	std::array<Buffer, 2> buffers;
+	size_t capacity, current;
+	size_t highWater;
+	uint64_t overflows;
+	std::mutex overflowLock;
+	std::atomic<std::thread::id> lockedOut; // checked in debug builds, see lockOut()
+
+	void reset(Buffer& buffer)
+	{
+		for (const Block& block : buffer.overflow)
+		{
+			if (block.alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+			{
+				::operator delete(block.memory, std::align_val_t{ block.alignment });
+			}
+			else
+			{
+				::operator delete(block.memory);
+			}
+		}
+		buffer.overflow.clear();
+		buffer.used.store(0, std::memory_order_relaxed);
+	}
+
+public:
+	explicit FrameArena(size_t capacity) : capacity(capacity), current(0), highWater(0), overflows(0), lockedOut(std::thread::id())
+	{
+		for (Buffer& buffer : buffers)
+		{
+			buffer.memory = std::make_unique<std::byte[]>(capacity);
+			buffer.used = 0;
+			buffer.overflow.reserve(64);
+		}
+	}
+	~FrameArena()
+	{
+		for (Buffer& buffer : buffers)
+		{
+			reset(buffer);
+		}
+	}
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// top of the frame, before anything allocates
+	void beginFrame()
+	{
+		assert(lockedOut.load(std::memory_order_relaxed) != std::this_thread::get_id());
+		highWater = std::max(highWater, used());
+		current ^= 1;
+		reset(buffers[current]);
+	}
+
+	void* allocate(size_t bytes, size_t alignment)
+	{
+		assert(lockedOut.load(std::memory_order_relaxed) != std::this_thread::get_id());
+		Buffer& buffer = buffers[current];
+		const size_t start = buffer.used.fetch_add(bytes + alignment - 1, std::memory_order_relaxed);
+		if (start + bytes + alignment - 1 <= capacity)
+		{
+			const uintptr_t address = reinterpret_cast<uintptr_t>(buffer.memory.get() + start);
+			return reinterpret_cast<void*>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+		}
+		std::lock_guard<std::mutex> guard(overflowLock);
+		overflows++;
+		void* block = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new(bytes, std::align_val_t{ alignment }) : ::operator new(bytes);
+		buffer.overflow.push_back(Block{ block, alignment });
+		return block;
+	}
+
+	// hand back everything allocated since mark(), for scratch that is dead before the frame
+	// ends. Only while no other thread allocates from the arena
+	size_t mark() const { return buffers[current].used.load(std::memory_order_relaxed); }
+	void rewind(size_t mark)
+	{
+		assert(lockedOut.load(std::memory_order_relaxed) != std::this_thread::get_id());
+		highWater = std::max(highWater, used());
+		buffers[current].used.store(mark, std::memory_order_relaxed);
+	}
+
+	// while another thread owns the arena and may rewind it, thread must not allocate from it;
+	// debug builds assert that. An empty id lifts the ban
+	void lockOut(std::thread::id thread) { lockedOut.store(thread, std::memory_order_relaxed); }
+
+	// bytes handed out this frame, including alignment slack
+	size_t used() const { return std::min(buffers[current].used.load(std::memory_order_relaxed), capacity); }
+	size_t getHighWater() const { return std::max(highWater, used()); }
+	size_t getCapacity() const { return capacity; }
+	uint64_t getOverflows() const { return overflows; }
+};
+
+// standard allocator over a FrameArena, for containers that are dropped within a frame
+template <typename T>
+class FrameAllocator {
+	template <typename U> friend class FrameAllocator;
+	FrameArena* arena;
+
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+
+	explicit FrameAllocator(FrameArena& arena) : arena(&arena) {}
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, size_t) {}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& other) const { return arena == other.arena; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
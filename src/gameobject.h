@@ -1,8 +1,8 @@
 #pragma once
 #include <glm/glm.hpp>
-#include <vector>
 #include <SDL3/SDL_main.h>
-#include "animation.h"
+#include "timer.h"
+#include "atlas.h"
 
 enum class PlayerState
 {
@@ -27,25 +27,22 @@ struct LevelData
 
 };
 
-struct EnemyData
-{
-
-};
-
 struct BulletData
 {
 	BulletState state;
-	BulletData() : state(BulletState::moving) {};
+	float hitTime; // seconds of hit animation left while colliding
+	BulletData() : state(BulletState::moving), hitTime(0) {};
 };
 
 union ObjectData
 {
 	PlayerData player;
 	LevelData level;
-	EnemyData enemy;
 	BulletData bullet;
 };
 
+// enemies are not GameObjects, they live in EnemySystem (enemies.h); the type still
+// tags them as the other side of a contact
 enum class ObjectType {
 	player, level, enemy, bullet
 };
@@ -55,11 +52,11 @@ struct GameObject
 	ObjectType type;
 	ObjectData data;
 	glm::vec2 position, velocity, acceleration;
+	glm::vec2 prevPosition; // position at the start of the last tick, for render interpolation
 	float direction;
 	float maxSpeedX;
-	std::vector<Animation> animations;
-	int currentAnimation;
-	SDL_Texture* texture;
+	int animation; // Animator instance, -1 when the object is not animated
+	const Sprite* sprite;
 	bool dynamic;
 	SDL_FRect collider;
 	bool grounded;
@@ -70,9 +67,9 @@ struct GameObject
 		type = ObjectType::level;
 		direction = 1;
 		maxSpeedX = 0;
-		position = velocity = acceleration = glm::vec2(0);
-		currentAnimation = -1;
-		texture = nullptr;
+		position = velocity = acceleration = prevPosition = glm::vec2(0);
+		animation = -1;
+		sprite = nullptr;
 		dynamic = false;
 		grounded	= false;
 	}
@@ -0,0 +1,215 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+// fixed pool of worker threads, each with its own deque of batches. Owners take from the
+// back of their deque, idle threads steal from the front of the others. The thread
+// calling parallelFor works on the batches too and returns once all of them are done
+class JobSystem {
+	struct Job
+	{
+		void (*run)(void* context, size_t batch, size_t begin, size_t end);
+		void* context;
+		size_t batch, begin, end;
+	};
+
+	// ring of batches; it only grows when a parallelFor hands out more batches than any
+	// before, so steady-state frames queue work without touching the heap
+	struct Queue
+	{
+		std::mutex lock;
+		std::vector<Job> ring;
+		size_t head, count;
+
+		Queue() : head(0), count(0) {}
+
+		void pushBack(const Job& job)
+		{
+			if (count == ring.size())
+			{
+				std::vector<Job> grown(std::max<size_t>(ring.size() * 2, 16));
+				for (size_t i = 0; i < count; i++)
+				{
+					grown[i] = ring[(head + i) % ring.size()];
+				}
+				ring.swap(grown);
+				head = 0;
+			}
+			ring[(head + count) % ring.size()] = job;
+			count++;
+		}
+
+		Job popBack()
+		{
+			count--;
+			return ring[(head + count) % ring.size()];
+		}
+
+		Job popFront()
+		{
+			const Job job = ring[head];
+			head = (head + 1) % ring.size();
+			count--;
+			return job;
+		}
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues; // 0 belongs to the calling thread
+	std::vector<std::thread> workers;
+	std::atomic<size_t> remaining;
+
+	std::mutex sleepLock;
+	std::condition_variable wake;
+	uint64_t generation;
+	bool quit;
+
+	template <typename Fn>
+	static void trampoline(void* context, size_t batch, size_t begin, size_t end)
+	{
+		(*static_cast<Fn*>(context))(batch, begin, end);
+	}
+
+	bool popOwn(size_t self, Job& job)
+	{
+		Queue& queue = *queues[self];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.count == 0)
+		{
+			return false;
+		}
+		job = queue.popBack();
+		return true;
+	}
+
+	bool steal(size_t self, Job& job)
+	{
+		for (size_t i = 1; i < queues.size(); i++)
+		{
+			Queue& victim = *queues[(self + i) % queues.size()];
+			std::lock_guard<std::mutex> guard(victim.lock);
+			if (victim.count != 0)
+			{
+				job = victim.popFront();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// run batches until none are left to take
+	void drain(size_t self)
+	{
+		Job job;
+		while (popOwn(self, job) || steal(self, job))
+		{
+			job.run(job.context, job.batch, job.begin, job.end);
+			remaining.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+
+	void workerLoop(size_t self)
+	{
+		uint64_t seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> guard(sleepLock);
+				wake.wait(guard, [this, seen]() { return quit || generation != seen; });
+				if (quit)
+				{
+					return;
+				}
+				seen = generation;
+			}
+			drain(self);
+		}
+	}
+
+public:
+	JobSystem() : remaining(0), generation(0), quit(false) {}
+	~JobSystem() { stop(); }
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// 0 workers keeps everything on the calling thread
+	void start(size_t workerCount)
+	{
+		stop();
+		quit = false;
+		queues.clear();
+		for (size_t i = 0; i <= workerCount; i++)
+		{
+			queues.push_back(std::make_unique<Queue>());
+		}
+		for (size_t i = 1; i <= workerCount; i++)
+		{
+			workers.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			quit = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		workers.clear();
+	}
+
+	size_t workerCount() const { return workers.size(); }
+
+	// number of batches parallelFor will cut count items into
+	static size_t batchCount(size_t count, size_t batchSize)
+	{
+		return (count + batchSize - 1) / batchSize;
+	}
+
+	// fn(batch, begin, end) over [0, count) in batches of batchSize. The batch split does not
+	// depend on the thread count, so per-batch results merged in batch order are the same
+	// on any machine and with no workers at all
+	template <typename Fn>
+	void parallelFor(size_t count, size_t batchSize, Fn&& fn)
+	{
+		using Body = std::remove_reference_t<Fn>;
+		const size_t batches = batchCount(count, batchSize);
+		if (workers.empty() || batches <= 1)
+		{
+			for (size_t b = 0; b < batches; b++)
+			{
+				fn(b, b * batchSize, std::min(count, (b + 1) * batchSize));
+			}
+			return;
+		}
+
+		remaining.store(batches, std::memory_order_release);
+		for (size_t b = 0; b < batches; b++)
+		{
+			Queue& queue = *queues[b % queues.size()];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			queue.pushBack(Job{ &trampoline<Body>, const_cast<void*>(static_cast<const void*>(&fn)), b, b * batchSize, std::min(count, (b + 1) * batchSize) });
+		}
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			generation++;
+		}
+		wake.notify_all();
+
+		drain(0);
+		while (remaining.load(std::memory_order_acquire) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+};
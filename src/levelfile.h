@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <fstream>
+
+/*
+Streamed level layout, little endian:
+	LevelHeader
+	chunkCount chunks, each layers * rows * chunkCols int16 tile ids,
+	layer-major then row-major; the last chunk is padded with empty tiles
+Chunks are fixed size so any column range can be read with one seek.
+*/
+const char LEVEL_MAGIC[4] = { 'R', 'P', 'G', 'L' };
+const uint32_t LEVEL_VERSION = 1;
+
+// tile layers stored in a level file
+const int LEVEL_LAYER_SOLID = 0;
+const int LEVEL_LAYER_FOREGROUND = 1;
+const int LEVEL_LAYER_BACKGROUND = 2;
+const int LEVEL_LAYERS = 3;
+
+// columns per chunk, also the width of one baked chunk texture in game
+const int LEVEL_CHUNK_COLS = 16;
+
+// solid layer tile id that spawns an enemy instead of a tile
+const int16_t LEVEL_TILE_ENEMY = 8;
+
+struct LevelHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t rows, cols, chunkCols, layers;
+	int32_t spawnRow, spawnCol;
+};
+
+static_assert(sizeof(LevelHeader) == 32, "level header layout changed");
+
+inline int levelChunkCount(const LevelHeader& header)
+{
+	return static_cast<int>((header.cols + header.chunkCols - 1) / header.chunkCols);
+}
+
+inline size_t levelChunkTiles(const LevelHeader& header)
+{
+	return static_cast<size_t>(header.layers) * header.rows * header.chunkCols;
+}
+
+// tile ids for one column range
+struct LevelChunk
+{
+	int index;
+	std::vector<int16_t> tiles;
+
+	LevelChunk() : index(-1) {}
+
+	int16_t at(const LevelHeader& header, int layer, int r, int c) const
+	{
+		return tiles[(static_cast<size_t>(layer) * header.rows + r) * header.chunkCols + c];
+	}
+};
+
+inline bool readLevelHeader(std::ifstream& file, LevelHeader& header)
+{
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	return file && std::memcmp(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) == 0 && header.version == LEVEL_VERSION &&
+		header.layers == LEVEL_LAYERS && header.rows > 0 && header.chunkCols > 0 && header.cols > 0;
+}
+
+// an unreadable chunk comes back empty rather than failing the stream
+inline void readLevelChunk(std::ifstream& file, const LevelHeader& header, int index, LevelChunk& chunk)
+{
+	const size_t count = levelChunkTiles(header);
+	chunk.index = index;
+	chunk.tiles.assign(count, 0);
+	file.clear();
+	file.seekg(sizeof(LevelHeader) + static_cast<uint64_t>(index) * count * sizeof(int16_t));
+	file.read(reinterpret_cast<char*>(chunk.tiles.data()), count * sizeof(int16_t));
+	if (!file)
+	{
+		chunk.tiles.assign(count, 0);
+	}
+}
+
+// tileAt(layer, r, c) supplies every tile of the level
+template <typename TileAt>
+bool writeLevel(const char* path, int rows, int cols, int chunkCols, int spawnRow, int spawnCol, TileAt&& tileAt)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+	LevelHeader header{};
+	std::memcpy(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+	header.version = LEVEL_VERSION;
+	header.rows = rows;
+	header.cols = cols;
+	header.chunkCols = chunkCols;
+	header.layers = LEVEL_LAYERS;
+	header.spawnRow = spawnRow;
+	header.spawnCol = spawnCol;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::vector<int16_t> tiles(levelChunkTiles(header));
+	for (int chunk = 0; chunk < levelChunkCount(header); chunk++)
+	{
+		size_t i = 0;
+		for (int layer = 0; layer < LEVEL_LAYERS; layer++)
+		{
+			for (int r = 0; r < rows; r++)
+			{
+				for (int c = 0; c < chunkCols; c++)
+				{
+					const int col = chunk * chunkCols + c;
+					tiles[i++] = col < cols ? static_cast<int16_t>(tileAt(layer, r, col)) : 0;
+				}
+			}
+		}
+		file.write(reinterpret_cast<const char*>(tiles.data()), tiles.size() * sizeof(int16_t));
+	}
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <fstream>
+#include "levelfile.h"
+#include "alloctrack.h"
+
+// keeps the level chunks around the camera resident; file reads happen on a
+// background thread and finished chunks are picked up by the main thread in update()
+class LevelStream {
+	std::string path;
+	LevelHeader header;
+	int radius;
+
+	// game-state owner only (main thread, or the pipeline worker between kick() and wait())
+	std::vector<LevelChunk> resident; // sorted by chunk index
+	std::vector<int> pending;
+	std::vector<LevelChunk> arrived;
+	std::ifstream file; // blocking reads, opened once
+
+	// shared with the worker
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done; // a chunk went into loaded
+	std::deque<int> requests;
+	std::vector<LevelChunk> loaded;
+	bool quit;
+	std::thread worker;
+
+	void run()
+	{
+		AllocTracker::ignoreThisThread(); // reads happen whenever, not as part of a frame
+		std::ifstream streamFile(path, std::ios::binary);
+		std::unique_lock<std::mutex> guard(lock);
+		while (true)
+		{
+			wake.wait(guard, [this]() { return quit || !requests.empty(); });
+			if (quit)
+			{
+				return;
+			}
+			const int index = requests.front();
+			requests.pop_front();
+			guard.unlock();
+
+			LevelChunk chunk;
+			readLevelChunk(streamFile, header, index, chunk);
+
+			guard.lock();
+			loaded.push_back(std::move(chunk));
+			done.notify_all();
+		}
+	}
+
+	bool isResident(int index) const
+	{
+		return std::any_of(resident.begin(), resident.end(), [index](const LevelChunk& chunk) { return chunk.index == index; });
+	}
+
+	// a chunk the worker has read or is reading, taken out of the stream; false when it
+	// was never requested or not picked up yet, in which case it is read here instead
+	bool takeStreamed(int index, LevelChunk& chunk)
+	{
+		if (std::find(pending.begin(), pending.end(), index) == pending.end())
+		{
+			return false;
+		}
+		pending.erase(std::remove(pending.begin(), pending.end(), index), pending.end());
+		std::unique_lock<std::mutex> guard(lock);
+		const auto queued = std::find(requests.begin(), requests.end(), index);
+		if (queued != requests.end())
+		{
+			requests.erase(queued);
+			return false;
+		}
+		const auto finished = [this, index]() {
+			return std::find_if(loaded.begin(), loaded.end(), [index](const LevelChunk& c) { return c.index == index; });
+		};
+		done.wait(guard, [this, &finished]() { return finished() != loaded.end(); });
+		const auto found = finished();
+		chunk = std::move(*found);
+		loaded.erase(found);
+		return true;
+	}
+
+	void install(LevelChunk&& chunk)
+	{
+		resident.push_back(std::move(chunk));
+		std::sort(resident.begin(), resident.end(), [](const LevelChunk& a, const LevelChunk& b) { return a.index < b.index; });
+	}
+
+public:
+	LevelStream() : header{}, radius(2), quit(false) {}
+	~LevelStream() { stop(); }
+
+	// reads and validates the header only
+	bool open(const std::string& path, int radius)
+	{
+		this->path = path;
+		this->radius = radius;
+		file.close();
+		file.open(path, std::ios::binary);
+		return file && readLevelHeader(file, header);
+	}
+
+	// blocking load of the window around a chunk, used before the first frame
+	void loadAround(int center)
+	{
+		const int first = std::max(center - radius, 0);
+		const int last = std::min(center + radius, levelChunkCount(header) - 1);
+		for (int i = first; i <= last; i++)
+		{
+			if (!isResident(i))
+			{
+				LevelChunk chunk;
+				readLevelChunk(file, header, i, chunk);
+				install(std::move(chunk));
+			}
+		}
+	}
+
+	// load of exactly these chunks, anything else resident is dropped. Replays use it to
+	// rebuild the windows a recorded session streamed in, snapshot loads to go back to an
+	// earlier window. Chunks the stream has read or is reading come from it; only the ones
+	// nobody has touched are read here, blocking
+	void loadChunks(const std::vector<int32_t>& indices)
+	{
+		resident.erase(std::remove_if(resident.begin(), resident.end(), [&indices](const LevelChunk& chunk) {
+			return std::find(indices.begin(), indices.end(), chunk.index) == indices.end();
+		}), resident.end());
+		for (const int32_t index : indices)
+		{
+			if (!isResident(index))
+			{
+				LevelChunk chunk;
+				if (!takeStreamed(index, chunk))
+				{
+					readLevelChunk(file, header, index, chunk);
+				}
+				install(std::move(chunk));
+			}
+		}
+	}
+
+	void start()
+	{
+		quit = false;
+		worker = std::thread(&LevelStream::run, this);
+	}
+
+	void stop()
+	{
+		if (!worker.joinable())
+		{
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			quit = true;
+		}
+		wake.notify_one();
+		worker.join();
+	}
+
+	// once per frame: request missing chunks near center, install finished loads and
+	// evict chunks that fell out of range; true when the resident set changed
+	bool update(int center)
+	{
+		const int count = levelChunkCount(header);
+		const int first = std::max(center - radius, 0);
+		const int last = std::min(center + radius, count - 1);
+		bool changed = false;
+
+		bool requested = false;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			for (int i = first; i <= last; i++)
+			{
+				if (!isResident(i) && std::find(pending.begin(), pending.end(), i) == pending.end())
+				{
+					pending.push_back(i);
+					requests.push_back(i);
+					requested = true;
+				}
+			}
+			arrived.swap(loaded);
+		}
+		if (requested)
+		{
+			wake.notify_one();
+		}
+
+		// one chunk of hysteresis so walking along a boundary doesn't thrash
+		const auto keep = [first, last](int index) { return index >= first - 1 && index <= last + 1; };
+		for (LevelChunk& chunk : arrived)
+		{
+			pending.erase(std::remove(pending.begin(), pending.end(), chunk.index), pending.end());
+			if (keep(chunk.index) && !isResident(chunk.index))
+			{
+				install(std::move(chunk));
+				changed = true;
+			}
+		}
+		arrived.clear();
+
+		const size_t before = resident.size();
+		resident.erase(std::remove_if(resident.begin(), resident.end(), [&keep](const LevelChunk& chunk) { return !keep(chunk.index); }), resident.end());
+		return changed || resident.size() != before;
+	}
+
+	const LevelHeader& getHeader() const { return header; }
+	const std::vector<LevelChunk>& chunks() const { return resident; }
+	std::vector<int32_t> residentIndices() const
+	{
+		std::vector<int32_t> indices;
+		for (const LevelChunk& chunk : resident)
+		{
+			indices.push_back(chunk.index);
+		}
+		return indices;
+	}
+	size_t residentBytes() const
+	{
+		return resident.size() * levelChunkTiles(header) * sizeof(int16_t);
+	}
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+enum class PacingMode
+{
+	vsync, adaptive, capped, uncapped, count
+};
+
+const char* const PACING_MODE_NAMES[] = { "vsync", "adaptive", "cap", "uncapped" };
+const size_t PACING_MODE_COUNT = static_cast<size_t>(PacingMode::count);
+const uint64_t PACING_SPIN_NS = 1000000;     // the last stretch before a capped deadline is busy-waited
+const float PACING_FALLBACK_HZ = 60.0f;      // when the display does not report a refresh rate
+const double PACING_MISS_FACTOR = 1.5;       // a frame later than this many periods missed its deadline
+
+inline bool parsePacingMode(const char* name, PacingMode& mode)
+{
+	for (size_t i = 0; i < PACING_MODE_COUNT; i++)
+	{
+		if (std::strcmp(name, PACING_MODE_NAMES[i]) == 0)
+		{
+			mode = static_cast<PacingMode>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+// present-to-present intervals of one mode, mean and variance kept with Welford's update
+struct PacingStats
+{
+	uint64_t frames, missed;
+	double meanMs, m2, worstMs;
+
+	PacingStats() : frames(0), missed(0), meanMs(0), m2(0), worstMs(0) {}
+
+	void add(double ms, bool miss)
+	{
+		frames++;
+		const double delta = ms - meanMs;
+		meanMs += delta / frames;
+		m2 += delta * (ms - meanMs);
+		worstMs = std::max(worstMs, ms);
+		missed += miss ? 1 : 0;
+	}
+
+	double varianceMs() const { return frames > 1 ? m2 / (frames - 1) : 0; }
+	double stdDevMs() const { return std::sqrt(varianceMs()); }
+};
+
+// decides when a frame is presented and measures how evenly frames come out. Vsync modes
+// leave the waiting to the driver; the cap sleeps to just before the deadline with
+// SDL_DelayPrecise and spins the rest. Every mode keeps its own statistics, so modes
+// switched at runtime can be compared
+class FramePacer {
+	std::array<PacingStats, PACING_MODE_COUNT> stats;
+	PacingMode mode;
+	uint64_t capNS;     // frame period of the cap
+	uint64_t refreshNS; // display refresh period, the deadline of every other mode
+	uint64_t deadline, lastPresent;
+
+	uint64_t periodNS() const { return mode == PacingMode::capped ? capNS : refreshNS; }
+
+public:
+	FramePacer() : mode(PacingMode::vsync), capNS(1000000000ull / 60), refreshNS(1000000000ull / 60), deadline(0), lastPresent(0) {}
+
+	// switch mode, the renderer's vsync follows it. Drivers without adaptive vsync fall
+	// back to plain vsync
+	void setMode(SDL_Window* window, SDL_Renderer* renderer, PacingMode next, int capFps)
+	{
+		const SDL_DisplayMode* display = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+		const float hz = display && display->refresh_rate > 0 ? display->refresh_rate : PACING_FALLBACK_HZ;
+		refreshNS = static_cast<uint64_t>(1e9 / hz);
+		capNS = 1000000000ull / std::max(capFps, 1);
+
+		mode = next;
+		int vsync = mode == PacingMode::vsync ? 1 : SDL_RENDERER_VSYNC_DISABLED;
+		if (mode == PacingMode::adaptive && !SDL_SetRenderVSync(renderer, SDL_RENDERER_VSYNC_ADAPTIVE))
+		{
+			SDL_Log("Adaptive vsync not supported, using vsync");
+			mode = PacingMode::vsync;
+			vsync = 1;
+		}
+		if (mode != PacingMode::adaptive)
+		{
+			SDL_SetRenderVSync(renderer, vsync);
+		}
+		deadline = lastPresent = 0;
+	}
+
+	void cycle(SDL_Window* window, SDL_Renderer* renderer, int capFps)
+	{
+		setMode(window, renderer, static_cast<PacingMode>((static_cast<size_t>(mode) + 1) % PACING_MODE_COUNT), capFps);
+		SDL_Log("Frame pacing: %s", PACING_MODE_NAMES[static_cast<size_t>(mode)]);
+	}
+
+	// call right before presenting; only the cap waits here
+	void wait()
+	{
+		if (mode != PacingMode::capped)
+		{
+			return;
+		}
+		uint64_t now = SDL_GetTicksNS();
+		if (deadline == 0 || now > deadline + capNS)
+		{
+			// first frame, or so far behind that catching up would only burst frames
+			deadline = now;
+			return;
+		}
+		if (deadline > now + PACING_SPIN_NS)
+		{
+			SDL_DelayPrecise(deadline - now - PACING_SPIN_NS);
+		}
+		while (SDL_GetTicksNS() < deadline)
+		{
+		}
+	}
+
+	// call right after presenting
+	void endFrame()
+	{
+		const uint64_t now = SDL_GetTicksNS();
+		if (lastPresent != 0)
+		{
+			const uint64_t interval = now - lastPresent;
+			stats[static_cast<size_t>(mode)].add(interval / 1e6, interval > periodNS() * PACING_MISS_FACTOR);
+		}
+		lastPresent = now;
+		if (mode == PacingMode::capped)
+		{
+			deadline += capNS;
+		}
+	}
+
+	PacingMode getMode() const { return mode; }
+	const char* modeName() const { return PACING_MODE_NAMES[static_cast<size_t>(mode)]; }
+	const PacingStats& current() const { return stats[static_cast<size_t>(mode)]; }
+	const PacingStats& of(PacingMode which) const { return stats[static_cast<size_t>(which)]; }
+};
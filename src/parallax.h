@@ -0,0 +1,155 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "atlas.h"
+#include "spritebatch.h"
+#include "renderqueue.h"
+
+// background layers composed into one screen-sized texture. Layers that do not scroll are
+// merged into a second texture once; the composite is only redrawn when a scrolling layer
+// moved by a whole pixel, every other frame the whole background is a single copy
+class ParallaxCompositor {
+	struct Layer
+	{
+		const Sprite* sprite;
+		float factor; // screen pixels per camera pixel, 0 stretches the layer over the screen
+		int offset;   // whole-pixel scroll the composite holds, -1 before the first draw
+	};
+
+	std::vector<Layer> layers;
+	SpriteBatch batch;
+	SDL_Texture* staticLayers;
+	SDL_Texture* composite;
+	int width, height;
+	float overdraw; // screen areas filled this frame
+	int redraws;
+
+	SDL_Texture* createTarget(SDL_Renderer* renderer)
+	{
+		SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, width, height);
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE); // both targets are opaque, copies need no blending
+		SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+		return texture;
+	}
+
+	void add(SDL_Renderer* renderer, const Sprite& sprite, const SDL_FRect& src, const SDL_FRect& dst)
+	{
+		batch.add(renderer, sprite, src, dst, false);
+		const float visibleW = std::min(dst.x + dst.w, static_cast<float>(width)) - std::max(dst.x, 0.0f);
+		const float visibleH = std::min(dst.y + dst.h, static_cast<float>(height)) - std::max(dst.y, 0.0f);
+		overdraw += std::max(visibleW, 0.0f) * std::max(visibleH, 0.0f) / (static_cast<float>(width) * height);
+	}
+
+	// static layers, once per target lifetime
+	void bakeStatic(SDL_Renderer* renderer)
+	{
+		SDL_SetRenderTarget(renderer, staticLayers);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+		const SDL_FRect screen{ 0, 0, static_cast<float>(width), static_cast<float>(height) };
+		for (const Layer& layer : layers)
+		{
+			if (layer.factor == 0)
+			{
+				add(renderer, *layer.sprite, SDL_FRect{ 0, 0, layer.sprite->rect.w, layer.sprite->rect.h }, screen);
+			}
+		}
+		batch.flush(renderer);
+	}
+
+	// the static copy with every scrolling layer tiled across at its offset
+	void compose(SDL_Renderer* renderer)
+	{
+		SDL_SetRenderTarget(renderer, composite);
+		SDL_RenderTexture(renderer, staticLayers, nullptr, nullptr);
+		overdraw += 1;
+		for (const Layer& layer : layers)
+		{
+			if (layer.factor == 0)
+			{
+				continue;
+			}
+			const float w = layer.sprite->rect.w, h = layer.sprite->rect.h;
+			for (float x = static_cast<float>(-layer.offset); x < width; x += w)
+			{
+				add(renderer, *layer.sprite, SDL_FRect{ 0, 0, w, h }, SDL_FRect{ x, 0, w, h });
+			}
+		}
+		batch.flush(renderer);
+		redraws++;
+	}
+
+public:
+	ParallaxCompositor() : staticLayers(nullptr), composite(nullptr), width(0), height(0), overdraw(0), redraws(0) {}
+
+	// layers are drawn back to front in the order they are added
+	void addLayer(const Sprite& sprite, float factor)
+	{
+		layers.push_back(Layer{ &sprite, factor, -1 });
+	}
+
+	// brings the composite up to date and queues it as the parallax layer
+	void draw(SDL_Renderer* renderer, RenderQueue& queue, float cameraX, int screenW, int screenH)
+	{
+		overdraw = 0;
+		redraws = 0;
+		const bool resized = !composite || screenW != width || screenH != height;
+		if (resized)
+		{
+			release();
+			width = screenW;
+			height = screenH;
+			staticLayers = createTarget(renderer);
+			composite = createTarget(renderer);
+		}
+
+		// layers move left as the camera moves right and wrap every sprite width
+		bool scrolled = false;
+		for (Layer& layer : layers)
+		{
+			if (layer.factor == 0)
+			{
+				continue;
+			}
+			const float w = layer.sprite->rect.w;
+			const float scroll = std::fmod(cameraX * layer.factor, w);
+			const int offset = static_cast<int>(std::floor(scroll < 0 ? scroll + w : scroll));
+			scrolled = scrolled || offset != layer.offset;
+			layer.offset = offset;
+		}
+
+		if (resized || scrolled)
+		{
+			Uint8 r, g, b, a;
+			SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+			SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer);
+			if (resized)
+			{
+				bakeStatic(renderer);
+			}
+			compose(renderer);
+			SDL_SetRenderTarget(renderer, prevTarget);
+			SDL_SetRenderDrawColor(renderer, r, g, b, a);
+		}
+		const SDL_FRect screen{ 0, 0, static_cast<float>(width), static_cast<float>(height) };
+		queue.add(RenderLayer::parallax, composite, screen, screen, false);
+		overdraw += 1;
+	}
+
+	// per-frame statistics: fullscreen-equivalents filled and composite redraws
+	float getOverdraw() const { return overdraw; }
+	int getRedraws() const { return redraws; }
+
+	void release()
+	{
+		SDL_DestroyTexture(staticLayers);
+		SDL_DestroyTexture(composite);
+		staticLayers = composite = nullptr;
+		for (Layer& layer : layers)
+		{
+			layer.offset = -1;
+		}
+	}
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// runs the same piece of work once per kick on a thread of its own, so the caller can get on
+// with something else until it needs the result. Started without a thread, kick() runs the
+// work in place and wait() returns at once
+class PipelineWorker {
+	std::function<void()> work;
+	std::thread thread;
+	std::mutex lock;
+	std::condition_variable signal;
+	bool pending, quit;
+
+	void loop()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (true)
+		{
+			signal.wait(guard, [this]() { return pending || quit; });
+			if (quit)
+			{
+				return;
+			}
+			guard.unlock();
+			work();
+			guard.lock();
+			pending = false;
+			signal.notify_all();
+		}
+	}
+
+public:
+	PipelineWorker() : pending(false), quit(false) {}
+	~PipelineWorker() { stop(); }
+	PipelineWorker(const PipelineWorker&) = delete;
+	PipelineWorker& operator=(const PipelineWorker&) = delete;
+
+	void start(std::function<void()> fn, bool threaded)
+	{
+		stop();
+		work = std::move(fn);
+		quit = false;
+		if (threaded)
+		{
+			thread = std::thread(&PipelineWorker::loop, this);
+		}
+	}
+
+	void stop()
+	{
+		if (!thread.joinable())
+		{
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			quit = true;
+		}
+		signal.notify_all();
+		thread.join();
+	}
+
+	bool threaded() const { return thread.joinable(); }
+
+	// the work must not touch anything the caller uses before wait()
+	void kick()
+	{
+		if (!thread.joinable())
+		{
+			work();
+			return;
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		pending = true;
+		signal.notify_all();
+	}
+
+	void wait()
+	{
+		if (!thread.joinable())
+		{
+			return;
+		}
+		std::unique_lock<std::mutex> guard(lock);
+		signal.wait(guard, [this]() { return !pending; });
+	}
+};
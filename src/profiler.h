@@ -0,0 +1,280 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <cstdio>
+
+// frame profiler: PROFILE_SCOPE("name") records a zone from there to the end of the
+// enclosing block. Without RPG_PROFILER the scopes expand to nothing and the
+// Profiler calls are empty inlines.
+
+#ifdef RPG_PROFILER
+#include <atomic>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+struct ProfileEvent
+{
+	const char* name; // must be a string literal, zones are told apart by pointer
+	uint64_t start, end;
+	uint32_t thread;
+	uint32_t frame;
+};
+
+class Profiler {
+	static const size_t CAPACITY = 1 << 16; // power of two
+	static const size_t WINDOW = 120;       // frames in the rolling averages and the graph
+
+	struct Zone
+	{
+		const char* name;
+		double frameMs;
+		double sumMs;
+		std::array<double, WINDOW> history;
+	};
+
+	// a ring entry; sequence is the claimed slot + 1 once the event is written, 0 while it
+	// is being written. The fields are atomic because a reader may copy them while a later
+	// lap overwrites the slot, the sequence tells it to throw that copy away
+	struct Slot
+	{
+		std::atomic<const char*> name;
+		std::atomic<uint64_t> start, end;
+		std::atomic<uint32_t> thread, frame;
+		std::atomic<uint64_t> sequence;
+	};
+
+	// ring of completed zones; writers claim a slot with one atomic add, so any thread can
+	// record without locking. Readers go through read(), which skips slots a writer has
+	// claimed but not finished, or has already reused for a later event
+	std::vector<Slot> ring;
+	std::atomic<uint64_t> head;
+	std::atomic<uint32_t> frameIndex;
+	uint64_t frameHead, frameStart;
+	double tickMs;
+
+	// main thread only
+	std::vector<Zone> zones;
+	std::array<double, WINDOW> frameMs;
+	std::array<SDL_FPoint, WINDOW> graph;
+	size_t cursor;
+	bool overlay;
+
+	Profiler() : ring(CAPACITY), head(0), frameIndex(0), frameHead(0), frameStart(SDL_GetPerformanceCounter()),
+		tickMs(1000.0 / SDL_GetPerformanceFrequency()), cursor(0), overlay(false)
+	{
+		zones.reserve(32);
+		frameMs.fill(0);
+	}
+
+	static uint32_t threadId()
+	{
+		static std::atomic<uint32_t> next(0);
+		thread_local const uint32_t id = next++;
+		return id;
+	}
+
+	Zone& zone(const char* name)
+	{
+		for (Zone& z : zones)
+		{
+			if (z.name == name)
+			{
+				return z;
+			}
+		}
+		zones.push_back(Zone{ name, 0, 0, {} });
+		return zones.back();
+	}
+
+	uint64_t oldestSlot(uint64_t end) const { return end > CAPACITY ? end - CAPACITY : 0; }
+
+	// copy of the event claimed as slot index, false when it is not (or no longer) there
+	bool read(uint64_t index, ProfileEvent& event) const
+	{
+		const Slot& slot = ring[index & (CAPACITY - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+		{
+			return false;
+		}
+		event = ProfileEvent{ slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+			slot.end.load(std::memory_order_relaxed), slot.thread.load(std::memory_order_relaxed), slot.frame.load(std::memory_order_relaxed) };
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+	}
+
+public:
+	static Profiler& instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+
+	void record(const char* name, uint64_t start, uint64_t end)
+	{
+		const uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+		Slot& slot = ring[index & (CAPACITY - 1)];
+		slot.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.start.store(start, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		slot.thread.store(threadId(), std::memory_order_relaxed);
+		slot.frame.store(frameIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		slot.sequence.store(index + 1, std::memory_order_release);
+	}
+
+	void beginFrame()
+	{
+		frameStart = SDL_GetPerformanceCounter();
+		frameHead = head.load(std::memory_order_acquire);
+	}
+
+	// closes the frame and folds its zones into the rolling averages
+	void endFrame()
+	{
+		const uint64_t now = SDL_GetPerformanceCounter();
+		record("frame", frameStart, now);
+
+		const uint64_t end = head.load(std::memory_order_acquire);
+		for (Zone& z : zones)
+		{
+			z.frameMs = 0;
+		}
+		for (uint64_t i = std::max(frameHead, oldestSlot(end)); i < end; i++)
+		{
+			ProfileEvent e;
+			if (read(i, e))
+			{
+				zone(e.name).frameMs += (e.end - e.start) * tickMs;
+			}
+		}
+		for (Zone& z : zones)
+		{
+			z.sumMs += z.frameMs - z.history[cursor];
+			z.history[cursor] = z.frameMs;
+		}
+		frameMs[cursor] = (now - frameStart) * tickMs;
+		cursor = (cursor + 1) % WINDOW;
+		frameIndex.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void toggleOverlay() { overlay = !overlay; }
+
+	// zone averages over the last WINDOW frames and a frame time graph, 33 ms is full height
+	void drawOverlay(SDL_Renderer* renderer, float x, float y)
+	{
+		if (!overlay)
+		{
+			return;
+		}
+		const float LINE = 10, GRAPH_H = 40, FULL_MS = 1000.0f / 30;
+		Uint8 r, g, b, a;
+		SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+		const SDL_FRect panel{ x, y, 8 * 26 + 8, LINE * zones.size() + GRAPH_H + 12 };
+		SDL_SetRenderDrawColor(renderer, 20, 20, 30, 255);
+		SDL_RenderFillRect(renderer, &panel);
+
+		SDL_SetRenderDrawColor(renderer, 230, 230, 230, 255);
+		char line[64];
+		float textY = y + 4;
+		for (const Zone& z : zones)
+		{
+			std::snprintf(line, sizeof(line), "%-16.16s %7.3f ms", z.name, z.sumMs / WINDOW);
+			SDL_RenderDebugText(renderer, x + 4, textY, line);
+			textY += LINE;
+		}
+
+		// oldest sample on the left
+		const float graphBottom = textY + 4 + GRAPH_H;
+		for (size_t i = 0; i < WINDOW; i++)
+		{
+			const double ms = frameMs[(cursor + i) % WINDOW];
+			graph[i] = SDL_FPoint{ x + 4 + i * (panel.w - 8) / WINDOW, graphBottom - std::min(static_cast<float>(ms) / FULL_MS, 1.0f) * GRAPH_H };
+		}
+		SDL_SetRenderDrawColor(renderer, 90, 90, 90, 255);
+		SDL_RenderLine(renderer, x + 4, graphBottom - GRAPH_H / 2, x + panel.w - 4, graphBottom - GRAPH_H / 2);
+		SDL_SetRenderDrawColor(renderer, 80, 220, 120, 255);
+		SDL_RenderLines(renderer, graph.data(), static_cast<int>(WINDOW));
+
+		SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	}
+
+	// writes the zones of the last frames still in the ring as Chrome trace JSON
+	// (chrome://tracing, Perfetto)
+	bool exportChromeTrace(const char* path, uint32_t frames)
+	{
+		FILE* out = std::fopen(path, "w");
+		if (!out)
+		{
+			return false;
+		}
+		const uint64_t end = head.load(std::memory_order_acquire);
+		const uint64_t begin = oldestSlot(end);
+		const uint32_t current = frameIndex.load(std::memory_order_relaxed);
+		const uint32_t firstFrame = current > frames ? current - frames : 0;
+
+		uint64_t origin = UINT64_MAX;
+		for (uint64_t i = begin; i < end; i++)
+		{
+			ProfileEvent e;
+			if (read(i, e) && e.frame >= firstFrame)
+			{
+				origin = std::min(origin, e.start);
+			}
+		}
+
+		std::fprintf(out, "{\"traceEvents\":[");
+		bool first = true;
+		for (uint64_t i = begin; i < end; i++)
+		{
+			ProfileEvent e;
+			if (!read(i, e) || e.frame < firstFrame)
+			{
+				continue;
+			}
+			std::fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%u}}",
+				first ? "" : ",", e.name, (e.start - origin) * tickMs * 1000, (e.end - e.start) * tickMs * 1000, e.thread, e.frame);
+			first = false;
+		}
+		std::fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+		return std::fclose(out) == 0;
+	}
+};
+
+// records the enclosing block as a zone
+class ProfileScope {
+	const char* name;
+	uint64_t start;
+
+public:
+	explicit ProfileScope(const char* name) : name(name), start(SDL_GetPerformanceCounter()) {}
+	~ProfileScope() { Profiler::instance().record(name, start, SDL_GetPerformanceCounter()); }
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profileScope, __LINE__)(name)
+
+#else
+
+class Profiler {
+public:
+	static Profiler& instance()
+	{
+		static Profiler profiler;
+		return profiler;
+	}
+	void beginFrame() {}
+	void endFrame() {}
+	void toggleOverlay() {}
+	void drawOverlay(SDL_Renderer*, float, float) {}
+	bool exportChromeTrace(const char*, uint32_t) { return false; }
+};
+
+#define PROFILE_SCOPE(name)
+
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <format>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include "atlas.h"
+#include "framearena.h"
+#include "spritebatch.h"
+
+// draw order, back to front
+enum class RenderLayer : uint8_t
+{
+	parallax, background, level, characters, enemies, bullets, foreground, count
+};
+
+const size_t RENDER_TEXT_LENGTH = 128;
+
+// one textured quad; src is in texture pixels, dst in render coordinates
+struct RenderCommand
+{
+	SDL_Texture* texture;
+	SDL_FRect src, dst;
+	uint32_t order; // submission order, quads of one texture keep it
+	RenderLayer layer;
+	bool flipX;
+};
+
+struct RenderText
+{
+	float x, y;
+	const char* text;
+};
+
+// everything a frame draws, recorded from the game state and executed later in one pass.
+// Commands are sorted by layer, then texture, so each texture of a layer is a single batch;
+// overlap between textures of one layer is not ordered. Both lists live in a FrameArena,
+// which keeps them valid into the next frame, so a frame can be executed while the next one
+// is simulated
+class RenderQueue {
+	FrameArena* arena;
+	FrameVector<RenderCommand> commands;
+	FrameVector<RenderText> texts;
+
+public:
+	explicit RenderQueue(FrameArena& arena)
+		: arena(&arena), commands(FrameAllocator<RenderCommand>(arena)), texts(FrameAllocator<RenderText>(arena)) {}
+
+	// start recording into the arena's current buffer, the previous recording is dropped
+	void begin()
+	{
+		const size_t expected = commands.size();
+		commands = FrameVector<RenderCommand>(FrameAllocator<RenderCommand>(*arena));
+		texts = FrameVector<RenderText>(FrameAllocator<RenderText>(*arena));
+		commands.reserve(expected);
+	}
+
+	void add(RenderLayer layer, SDL_Texture* texture, const SDL_FRect& src, const SDL_FRect& dst, bool flipX)
+	{
+		commands.push_back(RenderCommand{ texture, src, dst, static_cast<uint32_t>(commands.size()), layer, flipX });
+	}
+
+	// src is relative to the sprite rect
+	void add(RenderLayer layer, const Sprite& sprite, const SDL_FRect& src, const SDL_FRect& dst, bool flipX)
+	{
+		add(layer, sprite.texture, SDL_FRect{ sprite.rect.x + src.x, sprite.rect.y + src.y, src.w, src.h }, dst, flipX);
+	}
+
+	// debug text over everything else, in the draw color current when the queue is executed
+	template <typename... Args>
+	void text(float x, float y, std::format_string<Args...> format, Args&&... args)
+	{
+		char* line = static_cast<char*>(arena->allocate(RENDER_TEXT_LENGTH, 1));
+		*std::format_to_n(line, RENDER_TEXT_LENGTH - 1, format, std::forward<Args>(args)...).out = '\0';
+		texts.push_back(RenderText{ x, y, line });
+	}
+
+	void execute(SDL_Renderer* renderer, SpriteBatch& batch)
+	{
+		std::sort(commands.begin(), commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+			if (a.layer != b.layer)
+			{
+				return a.layer < b.layer;
+			}
+			if (a.texture != b.texture)
+			{
+				return std::less<SDL_Texture*>()(a.texture, b.texture);
+			}
+			return a.order < b.order;
+		});
+		for (const RenderCommand& command : commands)
+		{
+			batch.add(renderer, command.texture, command.src, command.dst, command.flipX);
+		}
+		batch.flush(renderer);
+		for (const RenderText& line : texts)
+		{
+			SDL_RenderDebugText(renderer, line.x, line.y, line.text);
+		}
+	}
+
+	size_t size() const { return commands.size(); }
+};
@@ -0,0 +1,282 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <string>
+#include <fstream>
+
+/*
+Input recording layout, little endian:
+	ReplayHeader
+	ticks bytes, the REPLAY_KEYS held during each tick as bits
+	ticks uint64 state checksums, taken after each tick
+	events ReplayEvent, in tick order
+	windows entries, each uint32 tick, uint32 count, count int32 chunk indices
+*/
+const char REPLAY_MAGIC[4] = { 'R', 'P', 'G', 'R' };
+const uint32_t REPLAY_VERSION = 1;
+
+// keys the simulation reads from the keyboard state, bit i of a tick is REPLAY_KEYS[i]
+const SDL_Scancode REPLAY_KEYS[] = { SDL_SCANCODE_A, SDL_SCANCODE_D, SDL_SCANCODE_F, SDL_SCANCODE_SPACE };
+const size_t REPLAY_KEY_COUNT = sizeof(REPLAY_KEYS) / sizeof(REPLAY_KEYS[0]);
+
+// bit of key in a packed key set, 0 for keys the simulation does not read
+inline uint8_t replayKeyBit(SDL_Scancode key)
+{
+	for (size_t i = 0; i < REPLAY_KEY_COUNT; i++)
+	{
+		if (REPLAY_KEYS[i] == key)
+		{
+			return static_cast<uint8_t>(1 << i);
+		}
+	}
+	return 0;
+}
+
+inline uint8_t packReplayKeys(const bool* keyboard)
+{
+	uint8_t bits = 0;
+	for (size_t i = 0; i < REPLAY_KEY_COUNT; i++)
+	{
+		bits |= keyboard[REPLAY_KEYS[i]] ? 1 << i : 0;
+	}
+	return bits;
+}
+
+inline void unpackReplayKeys(uint8_t bits, bool* keyboard)
+{
+	for (size_t i = 0; i < REPLAY_KEY_COUNT; i++)
+	{
+		keyboard[REPLAY_KEYS[i]] = (bits >> i & 1) != 0;
+	}
+}
+
+struct ReplayHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t tickRate, stress, levelCols;
+	uint32_t ticks, events, windows;
+};
+
+static_assert(sizeof(ReplayHeader) == 32, "replay header layout changed");
+
+// a key event, applied before the tick it was handled ahead of
+struct ReplayEvent
+{
+	uint32_t tick;
+	uint16_t scancode;
+	uint8_t down;
+	uint8_t padding;
+	uint64_t timestampNS;
+};
+
+static_assert(sizeof(ReplayEvent) == 16, "replay event layout changed");
+
+// the resident level chunks after a streaming update, applied before tick
+struct ReplayWindow
+{
+	uint32_t tick;
+	std::vector<int32_t> chunks;
+};
+
+// records everything a session feeds the simulation, one entry per fixed tick, or plays
+// such a recording back and checks every tick ends in the recorded state
+class InputReplay {
+public:
+	enum class Mode
+	{
+		off, record, play
+	};
+
+private:
+	Mode mode;
+	std::string path;
+	ReplayHeader header;
+	std::vector<uint8_t> keyBits;
+	std::vector<uint64_t> checksums;
+	std::vector<ReplayEvent> events;
+	std::vector<ReplayWindow> windows;
+
+	// playback
+	std::array<bool, SDL_SCANCODE_COUNT> keys;
+	size_t nextEvent, nextWindow;
+	uint32_t verified;
+	int64_t divergedAt; // first tick whose checksum differed, -1 while in step
+
+	template <typename T>
+	static void write(std::ofstream& file, const T* data, size_t count)
+	{
+		file.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+	}
+
+	template <typename T>
+	static bool read(std::ifstream& file, T* data, size_t count)
+	{
+		file.read(reinterpret_cast<char*>(data), count * sizeof(T));
+		return static_cast<bool>(file);
+	}
+
+public:
+	InputReplay() : mode(Mode::off), header{}, nextEvent(0), nextWindow(0), verified(0), divergedAt(-1) { keys.fill(false); }
+
+	void startRecording(const std::string& file, uint32_t tickRate, uint32_t stress, uint32_t levelCols)
+	{
+		mode = Mode::record;
+		path = file;
+		std::memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+		header.version = REPLAY_VERSION;
+		header.tickRate = tickRate;
+		header.stress = stress;
+		header.levelCols = levelCols;
+	}
+
+	bool startPlayback(const std::string& file)
+	{
+		std::ifstream in(file, std::ios::binary);
+		if (!in || !read(in, &header, 1) || std::memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 || header.version != REPLAY_VERSION)
+		{
+			return false;
+		}
+		keyBits.resize(header.ticks);
+		checksums.resize(header.ticks);
+		events.resize(header.events);
+		if (!read(in, keyBits.data(), keyBits.size()) || !read(in, checksums.data(), checksums.size()) || !read(in, events.data(), events.size()))
+		{
+			return false;
+		}
+		windows.resize(header.windows);
+		for (ReplayWindow& window : windows)
+		{
+			uint32_t count = 0;
+			if (!read(in, &window.tick, 1) || !read(in, &count, 1))
+			{
+				return false;
+			}
+			window.chunks.resize(count);
+			if (!read(in, window.chunks.data(), count))
+			{
+				return false;
+			}
+		}
+		mode = Mode::play;
+		path = file;
+		return true;
+	}
+
+	// room for a recording of up to ticks, so recording a headless run never allocates
+	void reserve(size_t ticks)
+	{
+		keyBits.reserve(ticks);
+		checksums.reserve(ticks);
+		events.reserve(ticks);
+	}
+
+	bool recording() const { return mode == Mode::record; }
+	bool playing() const { return mode == Mode::play; }
+
+	// what the recording was made with, the simulation has to match it
+	uint32_t getTickRate() const { return header.tickRate; }
+	uint32_t getStress() const { return header.stress; }
+	uint32_t getLevelCols() const { return header.levelCols; }
+
+	// recording: a key event handled before tick
+	void recordEvent(uint32_t tick, const SDL_KeyboardEvent& event)
+	{
+		events.push_back(ReplayEvent{ tick, static_cast<uint16_t>(event.scancode), static_cast<uint8_t>(event.down), 0, event.timestamp });
+	}
+
+	// recording: the level window changed before tick
+	void recordWindow(uint32_t tick, std::vector<int32_t> chunks)
+	{
+		windows.push_back(ReplayWindow{ tick, std::move(chunks) });
+	}
+
+	// playback: true once every recorded tick has run
+	bool finished(uint32_t tick) const { return tick >= keyBits.size(); }
+
+	// playback: the keyboard state of tick, valid until the next call
+	const bool* keysFor(uint32_t tick)
+	{
+		unpackReplayKeys(keyBits[tick], keys.data());
+		return keys.data();
+	}
+
+	// playback: fn(scancode, down) for every event recorded ahead of tick
+	template <typename Fn>
+	void eventsFor(uint32_t tick, Fn&& fn)
+	{
+		for (; nextEvent < events.size() && events[nextEvent].tick <= tick; nextEvent++)
+		{
+			fn(static_cast<SDL_Scancode>(events[nextEvent].scancode), events[nextEvent].down != 0);
+		}
+	}
+
+	// playback: the window to switch to before tick, nullptr when it did not change
+	const ReplayWindow* windowFor(uint32_t tick)
+	{
+		const ReplayWindow* window = nullptr;
+		for (; nextWindow < windows.size() && windows[nextWindow].tick <= tick; nextWindow++)
+		{
+			window = &windows[nextWindow];
+		}
+		return window;
+	}
+
+	// after every tick: recording stores the keys and checksum, playback compares them
+	void endTick(uint32_t tick, const bool* keyboard, uint64_t checksum)
+	{
+		if (mode == Mode::record)
+		{
+			keyBits.push_back(packReplayKeys(keyboard));
+			checksums.push_back(checksum);
+		}
+		else if (mode == Mode::play && tick < checksums.size())
+		{
+			if (checksums[tick] == checksum)
+			{
+				verified++;
+			}
+			else if (divergedAt < 0)
+			{
+				divergedAt = tick;
+				SDL_Log("Replay diverged at tick %u", tick);
+			}
+		}
+	}
+
+	uint32_t getVerified() const { return verified; }
+	int64_t getDivergedAt() const { return divergedAt; }
+	uint32_t tickCount() const { return static_cast<uint32_t>(keyBits.size()); }
+
+	// recording: write everything out
+	bool save()
+	{
+		if (mode != Mode::record)
+		{
+			return true;
+		}
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		header.ticks = static_cast<uint32_t>(keyBits.size());
+		header.events = static_cast<uint32_t>(events.size());
+		header.windows = static_cast<uint32_t>(windows.size());
+		write(file, &header, 1);
+		write(file, keyBits.data(), keyBits.size());
+		write(file, checksums.data(), checksums.size());
+		write(file, events.data(), events.size());
+		for (const ReplayWindow& window : windows)
+		{
+			const uint32_t count = static_cast<uint32_t>(window.chunks.size());
+			write(file, &window.tick, 1);
+			write(file, &count, 1);
+			write(file, window.chunks.data(), window.chunks.size());
+		}
+		return static_cast<bool>(file);
+	}
+};
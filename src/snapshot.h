@@ -0,0 +1,259 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+
+// appends trivially copyable values to a flat byte buffer. The buffer only grows, so once it
+// has held the largest state writing a snapshot is a series of memcpys
+class SnapshotWriter {
+	std::vector<uint8_t>& buffer;
+	size_t size;
+
+public:
+	explicit SnapshotWriter(std::vector<uint8_t>& buffer) : buffer(buffer), size(0) {}
+
+	template <typename T>
+	void write(const T* data, size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "snapshots are raw copies");
+		const size_t bytes = count * sizeof(T);
+		if (size + bytes > buffer.size())
+		{
+			buffer.resize(std::max(size + bytes, buffer.size() * 2));
+		}
+		if (bytes)
+		{
+			std::memcpy(buffer.data() + size, data, bytes);
+		}
+		size += bytes;
+	}
+
+	template <typename T>
+	void write(const T& value) { write(&value, 1); }
+
+	template <typename T>
+	void writeVector(const std::vector<T>& values)
+	{
+		const uint32_t count = static_cast<uint32_t>(values.size());
+		write(count);
+		write(values.data(), values.size());
+	}
+
+	// pads to whole 64-bit words, which is what SnapshotHistory compares; returns the size
+	size_t finish()
+	{
+		const uint64_t zero = 0;
+		write(reinterpret_cast<const uint8_t*>(&zero), (8 - size % 8) % 8);
+		return size;
+	}
+};
+
+// reads back what a SnapshotWriter wrote, in the same order. Vectors are resized to the
+// stored count, which only allocates when they have to grow past their capacity
+class SnapshotReader {
+	const uint8_t* data;
+	size_t offset;
+
+public:
+	explicit SnapshotReader(const uint8_t* data) : data(data), offset(0) {}
+
+	template <typename T>
+	void read(T* values, size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "snapshots are raw copies");
+		if (count)
+		{
+			std::memcpy(values, data + offset, count * sizeof(T));
+		}
+		offset += count * sizeof(T);
+	}
+
+	template <typename T>
+	void read(T& value) { read(&value, 1); }
+
+	template <typename T>
+	T read()
+	{
+		T value;
+		read(&value, 1);
+		return value;
+	}
+
+	template <typename T>
+	void readVector(std::vector<T>& values)
+	{
+		values.resize(read<uint32_t>());
+		read(values.data(), values.size());
+	}
+};
+
+/*
+The newest snapshot in full plus backward deltas, one per older snapshot. A delta is the
+newer snapshot XORed with the older one, stored as runs:
+	uint32 unchanged words, uint32 changed words, the changed words
+until both snapshots are covered. Deltas sit back to back in one fixed ring of words; a new
+one overwrites the oldest it overlaps, so the history holds as many ticks as fit in it (up to
+the depth) and capturing never allocates once the largest state has been seen. Stepping back
+XORs the newest delta into the full copy
+*/
+class SnapshotHistory {
+	struct Delta
+	{
+		size_t offset, words; // in storage
+		size_t size;          // bytes of the snapshot this delta restores
+	};
+
+	std::vector<uint64_t> storage;
+	std::vector<Delta> deltas; // ring, one slot per tick of depth
+	size_t head, count;        // next slot to write, deltas held
+	std::vector<uint64_t> latest, scratch;
+	size_t latestSize;
+	bool empty;
+	size_t lastDeltaBytes;
+
+	static uint64_t word(const uint8_t* data, size_t size, size_t i)
+	{
+		uint64_t value = 0;
+		if (i * 8 < size)
+		{
+			std::memcpy(&value, data + i * 8, 8);
+		}
+		return value;
+	}
+
+	// XOR of data against latest as runs, into scratch
+	void encode(const uint8_t* data, size_t size, size_t words)
+	{
+		if (scratch.capacity() < words * 2 + 2)
+		{
+			scratch.reserve(words * 2 + 2); // worst case, every other word changed
+		}
+		scratch.clear();
+		size_t i = 0;
+		while (i < words)
+		{
+			const size_t runStart = i;
+			while (i < words && word(data, size, i) == latest[i])
+			{
+				i++;
+			}
+			const size_t changedStart = i;
+			while (i < words && word(data, size, i) != latest[i])
+			{
+				i++;
+			}
+			scratch.push_back(static_cast<uint64_t>(changedStart - runStart) << 32 | (i - changedStart));
+			for (size_t w = changedStart; w < i; w++)
+			{
+				scratch.push_back(word(data, size, w) ^ latest[w]);
+			}
+		}
+	}
+
+	// copy scratch in after the newest delta, dropping the oldest ones in its way
+	void store(size_t size)
+	{
+		const size_t words = scratch.size();
+		if (words > storage.size())
+		{
+			count = 0; // larger than the whole ring, the history starts over
+			return;
+		}
+		size_t offset = 0;
+		if (count > 0)
+		{
+			const Delta& newest = deltas[(head + deltas.size() - 1) % deltas.size()];
+			offset = newest.offset + newest.words;
+		}
+		if (offset + words > storage.size())
+		{
+			offset = 0;
+		}
+		// after a wrap the oldest delta can sit past the new range while newer ones lie under
+		// it, so everything up to the newest delta in the way goes
+		size_t evict = count == deltas.size() ? 1 : 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			const Delta& held = deltas[(head + deltas.size() - count + i) % deltas.size()];
+			if (held.offset < offset + words && offset < held.offset + held.words)
+			{
+				evict = i + 1;
+			}
+		}
+		count -= evict;
+		std::copy(scratch.begin(), scratch.end(), storage.begin() + offset);
+		deltas[head] = Delta{ offset, words, size };
+		head = (head + 1) % deltas.size();
+		count++;
+	}
+
+public:
+	SnapshotHistory(size_t depth, size_t bytes)
+		: storage(bytes / 8), deltas(std::max<size_t>(depth, 1)), head(0), count(0), latestSize(0), empty(true), lastDeltaBytes(0) {}
+
+	// size is a SnapshotWriter::finish result, a multiple of 8
+	void push(const uint8_t* data, size_t size)
+	{
+		const size_t words = std::max(size, latestSize) / 8;
+		if (latest.size() < words)
+		{
+			latest.resize(words, 0);
+		}
+		if (!empty)
+		{
+			encode(data, size, words);
+			lastDeltaBytes = scratch.size() * 8;
+			store(latestSize);
+		}
+		std::memcpy(latest.data(), data, size);
+		std::fill(latest.begin() + size / 8, latest.begin() + words, 0);
+		latestSize = size;
+		empty = false;
+	}
+
+	// make the snapshot before the newest one the newest, false when there is none left
+	bool stepBack()
+	{
+		if (count == 0)
+		{
+			return false;
+		}
+		head = (head + deltas.size() - 1) % deltas.size();
+		count--;
+		const Delta& delta = deltas[head];
+		const size_t words = std::max(delta.size, latestSize) / 8;
+		if (latest.size() < words)
+		{
+			latest.resize(words, 0);
+		}
+		const uint64_t* runs = storage.data() + delta.offset;
+		size_t i = 0;
+		for (size_t r = 0; r < delta.words; )
+		{
+			const uint64_t run = runs[r++];
+			i += run >> 32;
+			for (uint64_t changed = run & 0xffffffffu; changed > 0; changed--)
+			{
+				latest[i++] ^= runs[r++];
+			}
+		}
+		latestSize = delta.size;
+		return true;
+	}
+
+	void clear()
+	{
+		head = count = 0;
+		latestSize = 0;
+		empty = true;
+		std::fill(latest.begin(), latest.end(), 0);
+	}
+
+	const uint8_t* newest() const { return reinterpret_cast<const uint8_t*>(latest.data()); }
+	size_t newestBytes() const { return latestSize; }
+	size_t depth() const { return count; } // steps back available
+	size_t getLastDeltaBytes() const { return lastDeltaBytes; }
+	size_t memoryBytes() const { return (storage.size() + latest.capacity() + scratch.capacity()) * 8; }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <vector>
+#include <utility>
+#include <initializer_list>
+#include "atlas.h"
+
+// collects textured quads and submits them with a single SDL_RenderGeometry
+// call per texture; buffers keep their capacity between frames
+class SpriteBatch {
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+	SDL_Texture* texture;
+	int drawCalls, quads;
+
+public:
+	SpriteBatch() : texture(nullptr), drawCalls(0), quads(0) {}
+
+	void reserve(size_t quadCount)
+	{
+		vertices.reserve(quadCount * 4);
+		indices.reserve(quadCount * 6);
+	}
+
+	// src is in texture pixels, dst is in render coordinates
+	void add(SDL_Renderer* renderer, SDL_Texture* quadTexture, const SDL_FRect& src, const SDL_FRect& dst, bool flipX)
+	{
+		if (quadTexture != texture)
+		{
+			flush(renderer);
+			texture = quadTexture;
+		}
+
+		const float texW = static_cast<float>(texture->w);
+		const float texH = static_cast<float>(texture->h);
+		float u0 = src.x / texW;
+		float u1 = (src.x + src.w) / texW;
+		const float v0 = src.y / texH;
+		const float v1 = (src.y + src.h) / texH;
+		if (flipX)
+		{
+			std::swap(u0, u1);
+		}
+
+		const int base = static_cast<int>(vertices.size());
+		const SDL_FColor white{ 1, 1, 1, 1 };
+		vertices.push_back(SDL_Vertex{ { dst.x, dst.y }, white, { u0, v0 } });
+		vertices.push_back(SDL_Vertex{ { dst.x + dst.w, dst.y }, white, { u1, v0 } });
+		vertices.push_back(SDL_Vertex{ { dst.x + dst.w, dst.y + dst.h }, white, { u1, v1 } });
+		vertices.push_back(SDL_Vertex{ { dst.x, dst.y + dst.h }, white, { u0, v1 } });
+		for (int i : { 0, 1, 2, 0, 2, 3 })
+		{
+			indices.push_back(base + i);
+		}
+		quads++;
+	}
+
+	// src is relative to the sprite rect
+	void add(SDL_Renderer* renderer, const Sprite& sprite, const SDL_FRect& src, const SDL_FRect& dst, bool flipX)
+	{
+		add(renderer, sprite.texture, SDL_FRect{ sprite.rect.x + src.x, sprite.rect.y + src.y, src.w, src.h }, dst, flipX);
+	}
+
+	void flush(SDL_Renderer* renderer)
+	{
+		if (!indices.empty())
+		{
+			SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+				indices.data(), static_cast<int>(indices.size()));
+			drawCalls++;
+		}
+		vertices.clear();
+		indices.clear();
+	}
+
+	// per-frame statistics
+	void resetStats() { drawCalls = quads = 0; }
+	int getDrawCalls() const { return drawCalls; }
+	int getQuads() const { return quads; }
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include <cmath>
+#include <algorithm>
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+#include "tilemap.h"
+
+const float SWEEP_SKIN = 0.01f;     // pixels of overlap still treated as touching
+const int SWEEP_MAX_SLIDES = 3;     // each contact removes one axis of motion, so 3 always suffice
+
+struct SweepHit
+{
+	float time;       // fraction of the move done before contact, 0..1
+	glm::vec2 normal; // points away from the cell that was hit
+};
+
+// time of impact of box a moving by delta against the static box b. Boxes that only touch
+// along an edge parallel to the move, or that are already moving apart, do not hit
+inline bool sweepBox(const SDL_FRect& a, glm::vec2 delta, const SDL_FRect& b, SweepHit& hit)
+{
+	const float aMin[2]{ a.x, a.y }, aMax[2]{ a.x + a.w, a.y + a.h };
+	const float bMin[2]{ b.x, b.y }, bMax[2]{ b.x + b.w, b.y + b.h };
+	float entry[2], exit[2];
+	for (int k = 0; k < 2; k++)
+	{
+		if (delta[k] > 0)
+		{
+			entry[k] = (bMin[k] - aMax[k]) / delta[k];
+			exit[k] = (bMax[k] - aMin[k]) / delta[k];
+		}
+		else if (delta[k] < 0)
+		{
+			entry[k] = (bMax[k] - aMin[k]) / delta[k];
+			exit[k] = (bMin[k] - aMax[k]) / delta[k];
+		}
+		else
+		{
+			if (aMax[k] - bMin[k] <= SWEEP_SKIN || bMax[k] - aMin[k] <= SWEEP_SKIN)
+			{
+				return false;
+			}
+			entry[k] = -INFINITY;
+			exit[k] = INFINITY;
+		}
+	}
+	const int axis = entry[0] > entry[1] ? 0 : 1;
+	const float enter = entry[axis], leave = std::min(exit[0], exit[1]);
+	if (enter > leave || enter > 1 || leave <= 0)
+	{
+		return false;
+	}
+	// deeper than the skin means the boxes already overlapped, that is pushOut's job
+	if (enter * std::abs(delta[axis]) < -SWEEP_SKIN)
+	{
+		return false;
+	}
+	hit.time = std::max(enter, 0.0f);
+	hit.normal = glm::vec2(0);
+	hit.normal[axis] = delta[axis] > 0 ? -1.0f : 1.0f;
+	return true;
+}
+
+struct MoveResult
+{
+	glm::vec2 position, velocity;
+	bool grounded; // stopped by something below during this move
+	bool blocked;  // stopped by anything
+};
+
+// move a collider (relative to position) by velocity * deltaTime through the solid cells of
+// layer, sliding along what it hits. Contacts come from the time of impact, not from the end
+// position, so any speed and step size is safe and the order cells are visited in does not matter
+inline MoveResult moveBox(const TileMap& tiles, int layer, const SDL_FRect& collider, glm::vec2 position, glm::vec2 velocity, float deltaTime)
+{
+	MoveResult result{ position, velocity, false, false };
+
+	// started inside a cell (pushed there by something else): leave along the shallow axis
+	const SDL_FRect start{ position.x + collider.x, position.y + collider.y, collider.w, collider.h };
+	tiles.query(layer, start, 0, [&](const SDL_FRect& tile) {
+		const SDL_FRect box{ result.position.x + collider.x, result.position.y + collider.y, collider.w, collider.h };
+		SDL_FRect overlap;
+		if (!SDL_GetRectIntersectionFloat(&box, &tile, &overlap) || overlap.w <= SWEEP_SKIN || overlap.h <= SWEEP_SKIN)
+		{
+			return;
+		}
+		if (overlap.w < overlap.h)
+		{
+			result.position.x += box.x < tile.x ? -overlap.w : overlap.w;
+		}
+		else
+		{
+			result.position.y += box.y < tile.y ? -overlap.h : overlap.h;
+		}
+	});
+
+	glm::vec2 delta = velocity * deltaTime;
+	for (int slide = 0; slide < SWEEP_MAX_SLIDES && (delta.x != 0 || delta.y != 0); slide++)
+	{
+		const SDL_FRect box{ result.position.x + collider.x, result.position.y + collider.y, collider.w, collider.h };
+		const SDL_FRect swept{ box.x + std::min(delta.x, 0.0f), box.y + std::min(delta.y, 0.0f), box.w + std::abs(delta.x), box.h + std::abs(delta.y) };
+
+		// earliest contact over every cell the move covers, floors win ties so walking over
+		// the seam between two floor cells does not catch on it
+		SweepHit first{ 2.0f, glm::vec2(0) };
+		tiles.query(layer, swept, 0, [&](const SDL_FRect& tile) {
+			SweepHit hit;
+			if (sweepBox(box, delta, tile, hit) && (hit.time < first.time || (hit.time == first.time && hit.normal.y != 0)))
+			{
+				first = hit;
+			}
+		});
+		if (first.time > 1)
+		{
+			result.position += delta;
+			break;
+		}
+
+		// move up to the contact and drop the blocked axis from the rest of the move
+		result.position += delta * first.time;
+		delta *= 1 - first.time;
+		result.blocked = true;
+		if (first.normal.x != 0)
+		{
+			delta.x = 0;
+			result.velocity.x = 0;
+		}
+		else
+		{
+			delta.y = 0;
+			result.velocity.y = 0;
+			result.grounded = result.grounded || first.normal.y < 0;
+		}
+	}
+	return result;
+}
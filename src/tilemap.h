@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <SDL3/SDL.h>
+#include "atlas.h"
+
+// tile ids index the per-id table, 0 is always an empty cell
+using TileId = uint8_t;
+const TileId TILE_EMPTY = 0;
+
+// everything tiles of one id have in common
+struct TileInfo
+{
+	const Sprite* sprite;
+	SDL_FRect collider; // relative to the cell
+	bool solid;
+};
+
+// static level tiles for the resident part of the level: one byte per cell per layer,
+// each layer a contiguous row-major array; columns are relative to originCol
+class TileMap {
+	int layerCount, rows, cols, originCol, tileSize;
+	float originY;
+	std::vector<TileId> cells;
+	std::vector<TileInfo> table;
+
+	size_t cellIndex(int layer, int r, int c) const
+	{
+		return (static_cast<size_t>(layer) * rows + r) * cols + c;
+	}
+
+public:
+	TileMap() : layerCount(0), rows(0), cols(0), originCol(0), tileSize(1), originY(0) {}
+
+	// entry 0 is forced empty, ids past the end of the table read as empty
+	void setTable(const std::vector<TileInfo>& table)
+	{
+		this->table = table;
+		if (this->table.empty())
+		{
+			this->table.push_back(TileInfo{ nullptr, {}, false });
+		}
+		this->table[TILE_EMPTY] = TileInfo{ nullptr, {}, false };
+	}
+
+	// clears every layer to empty
+	void resize(int layerCount, int rows, int cols, int originCol, int tileSize, float originY)
+	{
+		this->layerCount = layerCount;
+		this->rows = rows;
+		this->cols = cols;
+		this->originCol = originCol;
+		this->tileSize = tileSize;
+		this->originY = originY;
+		cells.assign(static_cast<size_t>(layerCount) * rows * cols, TILE_EMPTY);
+	}
+
+	void set(int layer, int r, int c, int id)
+	{
+		cells[cellIndex(layer, r, c)] = id > 0 && id < static_cast<int>(table.size()) ? static_cast<TileId>(id) : TILE_EMPTY;
+	}
+
+	TileId at(int layer, int r, int c) const
+	{
+		if (r < 0 || r >= rows || c < 0 || c >= cols)
+		{
+			return TILE_EMPTY;
+		}
+		return cells[cellIndex(layer, r, c)];
+	}
+
+	const TileInfo& info(TileId id) const { return table[id]; }
+
+	int getLayers() const { return layerCount; }
+	int getRows() const { return rows; }
+	int getCols() const { return cols; }
+	int getOriginCol() const { return originCol; }
+	int getTileSize() const { return tileSize; }
+	float getOriginY() const { return originY; }
+	int colAt(float x) const { return static_cast<int>(std::floor(x / tileSize)) - originCol; }
+	int rowAt(float y) const { return static_cast<int>(std::floor((y - originY) / tileSize)); }
+
+	// world position of a cell's top left corner
+	float cellX(int c) const { return static_cast<float>((originCol + c) * tileSize); }
+	float cellY(int r) const { return originY + r * tileSize; }
+
+	// visit the world collider of every solid cell of a layer touched by rect
+	// (grown by margin cells), in row-major order
+	template <typename Visitor>
+	void query(int layer, const SDL_FRect& rect, int margin, Visitor&& visit) const
+	{
+		const int r0 = std::max(rowAt(rect.y) - margin, 0);
+		const int r1 = std::min(rowAt(rect.y + rect.h) + margin, rows - 1);
+		const int c0 = std::max(colAt(rect.x) - margin, 0);
+		const int c1 = std::min(colAt(rect.x + rect.w) + margin, cols - 1);
+		if (c0 > c1)
+		{
+			return; // also an empty window, where cells has nothing to point into
+		}
+		for (int r = r0; r <= r1; r++)
+		{
+			const TileId* row = &cells[cellIndex(layer, r, 0)];
+			for (int c = c0; c <= c1; c++)
+			{
+				const TileInfo& tile = table[row[c]];
+				if (tile.solid)
+				{
+					const SDL_FRect collider{
+						.x = cellX(c) + tile.collider.x,
+						.y = cellY(r) + tile.collider.y,
+						.w = tile.collider.w,
+						.h = tile.collider.h
+					};
+					visit(collider);
+				}
+			}
+		}
+	}
+
+	// non-empty cells over all layers
+	size_t occupied() const
+	{
+		return cells.size() - static_cast<size_t>(std::count(cells.begin(), cells.end(), TILE_EMPTY));
+	}
+
+	size_t memoryBytes() const
+	{
+		return cells.capacity() * sizeof(TileId) + table.capacity() * sizeof(TileInfo);
+	}
+};